@@ -1,5 +1,7 @@
 #pragma once
+#if defined(_MSC_VER)
 #pragma warning(disable: 4530) // Disable execption warning
+#endif
 
 // C/C++
 #include <stdint.h>
@@ -10,9 +12,11 @@
 
 #if defined(_WIN64)
 #include <DirectXMath.h>
+#else
+#include "../Utilities/PortableMath.h"
 #endif
 
 // Common Headers
 #include "PrimitiveTypes.h"
-#include "..\Utilities\Utilities.h"
-#include "..\Utilities\MathTypes.h"
\ No newline at end of file
+#include "../Utilities/Utilities.h"
+#include "../Utilities/MathTypes.h"
\ No newline at end of file
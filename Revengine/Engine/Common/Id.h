@@ -1,41 +1,75 @@
 #pragma once
 #include "CommonHeaders.h"
+#include <type_traits>
+
+// Set to 1 to use 64-bit ids, which are split into 32 index bits and 32 generation bits
+#ifndef USE_64BIT_IDS
+#define USE_64BIT_IDS 0
+#endif
 
 namespace revengine::id {
 	// Revengine uses a generation/index system to reference certain ids - these will help us lookup a Grievance or Motivator within
 	// their respective arrays easily. Generations are used to distinguish Grievances created at the same index slot, and will take
-	// up the first 8 bits, meaning that our 30 bits are split into 22 index bits and 8 generation bits, which is a minimum of 
-	// 4 million simultaneous entries. We can only, however, distinguish between 256 entries created in the same slot.
+	// up the top bits of the id. By default, our 32 bits are split into 24 index bits and 8 generation bits, which is a minimum of
+	// 16 million simultaneous entries. We can only, however, distinguish between 255 entries created in the same slot. Once a slot
+	// has used up its generations, it is retired instead of wrapping around, so that old ids never alias new entries.
+
+	/// <summary>
+	/// Describes how an id of type T is split into index bits and generation bits
+	/// </summary>
+	template<typename T, u32 generation_bit_count>
+	struct layout {
+		static_assert(std::is_unsigned_v<T>);
+		static_assert(generation_bit_count > 0 && generation_bit_count < sizeof(T) * 8);
+
+		using id_type = T;
+		static constexpr u32 generation_bits{ generation_bit_count };
+		static constexpr u32 index_bits{ sizeof(id_type) * 8 - generation_bits };
+		static constexpr id_type index_mask{ (id_type{1} << index_bits) - 1 };
+		static constexpr id_type generation_mask{ (id_type{1} << generation_bits) - 1 };
+
+		// The last generation a slot can reach - the generation after that would be the same as the generation of invalid_id
+		static constexpr id_type max_generation{ generation_mask - 1 };
+
+		using generation_type = std::conditional_t<generation_bits <= 16, std::conditional_t<generation_bits <= 8, u8, u16>,
+			std::conditional_t<generation_bits <= 32, u32, u64>>;
+
+		// Check that generation_type is not bigger than generation_bits and that
+		// id_type is not bigger than index_bits
+		static_assert(sizeof(generation_type) * 8 >= generation_bits);
+		static_assert((sizeof(id_type) - sizeof(generation_type)) > 0);
+	};
+
+#if USE_64BIT_IDS
+	using id_layout = layout<u64, 32>;
+#else
+	using id_layout = layout<u32, 8>;
+#endif
 
 	// Set the amount of bits for an id
-	using id_type = u32;
+	using id_type = id_layout::id_type;
+	using generation_type = id_layout::generation_type;
 
 	// Use an internal namespace to prevent external use
 	namespace detail {
 		// Establish generation and index bits and masks
-		constexpr u32 generation_bits{ 8 };
-		constexpr u32 index_bits{ sizeof(id_type) * 8 - generation_bits };
-		constexpr id_type index_mask{ (id_type{1} << index_bits) - 1 };
-		constexpr id_type generation_mask{ (id_type{1} << generation_bits) - 1 };
+		constexpr u32 generation_bits{ id_layout::generation_bits };
+		constexpr u32 index_bits{ id_layout::index_bits };
+		constexpr id_type index_mask{ id_layout::index_mask };
+		constexpr id_type generation_mask{ id_layout::generation_mask };
 	}
 
 	constexpr id_type invalid_id{ id_type(-1) };
 	constexpr u32 min_deleted_elements{ 1024 }; // After 1024 elements, write back to the available slots
 
-	using generation_type = std::conditional_t<detail::generation_bits <= 16, std::conditional_t<detail::generation_bits <= 8, u8, u16>, u32>;
-
-	// Check that generation_type is not bigger than generation_bits and that 
-	// id_type is not bigger than index_bits
-	static_assert(sizeof(generation_type) * 8 >= detail::generation_bits);
-	static_assert((sizeof(id_type) - sizeof(generation_type)) > 0);
-
 	/// <summary>
 	/// Check if the ID is valid (if it's not -1)
 	/// </summary>
 	/// <param name="id">The ID to check</param>
 	/// <returns>True if the ID is valid, false otherwise</returns>
-	constexpr bool is_valid(id_type id) {
-		return id != invalid_id;
+	template<typename L = id_layout>
+	constexpr bool is_valid(typename L::id_type id) {
+		return id != typename L::id_type(-1);
 	}
 
 	/// <summary>
@@ -43,10 +77,11 @@ namespace revengine::id {
 	/// </summary>
 	/// <param name="id">The ID to retrieve the index part from</param>
 	/// <returns>The index part of the ID</returns>
-	constexpr id_type index(id_type id) {
+	template<typename L = id_layout>
+	constexpr typename L::id_type index(typename L::id_type id) {
 		// Check if the index part of the id is a valid value
-		id_type index{ id & detail::index_mask };
-		assert(index != detail::index_mask);
+		typename L::id_type index{ id & L::index_mask };
+		assert(index != L::index_mask);
 		return index;
 	}
 
@@ -55,28 +90,62 @@ namespace revengine::id {
 	/// </summary>
 	/// <param name="id">The ID to retrieve the generation part from</param>
 	/// <returns>The generation part of the ID</returns>
-	constexpr id_type generation(id_type id) {
-		return (id >> detail::index_bits) & detail::generation_mask;
+	template<typename L = id_layout>
+	constexpr typename L::id_type generation(typename L::id_type id) {
+		return (id >> L::index_bits) & L::generation_mask;
+	}
+
+	/// <summary>
+	/// Check if the slot of the ID can be used again with a new generation. Slots that can't are retired for good
+	/// </summary>
+	/// <param name="id">The ID of the slot to check</param>
+	/// <returns>True if the generation can still be incremented, false otherwise</returns>
+	template<typename L = id_layout>
+	constexpr bool can_recycle(typename L::id_type id) {
+		return generation<L>(id) < L::max_generation;
+	}
+
+	/// <summary>
+	/// Check if more slots can be added without their indices running into the generation bits. Retired slots are
+	/// never reused, so the slot arrays of long running programs keep growing until they reach this limit
+	/// </summary>
+	/// <param name="slot_count">The amount of slots there are now</param>
+	/// <param name="added">The amount of slots to add</param>
+	/// <returns>True if every new slot gets a valid index, false otherwise</returns>
+	template<typename L = id_layout>
+	constexpr bool can_add_slots(u64 slot_count, u64 added = 1) {
+		// The highest index is left out, as index() treats it as invalid
+		return slot_count + added <= (u64)L::index_mask;
 	}
 
 	/// <summary>
 	/// Increment the generation
 	/// </summary>
-	/// 
+	///
 	/// <param name="id">The ID of whose generation to increment</param>
 	/// <returns>The ID with an incremented generation</returns>
-	constexpr id_type new_generation(id_type id) {
+	template<typename L = id_layout>
+	constexpr typename L::id_type new_generation(typename L::id_type id) {
+		using id_type = typename L::id_type;
+
 		// Get the generation and add 1
-		const id_type generation{ id::generation(id) + 1 };
+		const id_type generation{ id::generation<L>(id) + 1 };
 
-		// Asser that the generation is smaller than the max value of the max generation bits
-		//  - it will wrap around otherwise and give the wrong id when asked for
-		assert(generation < (((u64)1 << detail::generation_bits) - 1));
+		// Assert that the generation is not bigger than the max generation - it will wrap around otherwise and
+		// give the wrong id when asked for. Callers have to check can_recycle() before reusing a slot
+		assert(generation <= L::max_generation);
 
 		// Get the new generation and shift it back to it's original place
-		return index(id) | (generation << detail::index_bits);
+		return index<L>(id) | (generation << L::index_bits);
 	}
 
+	// Make sure the supported layouts keep generations and indices apart
+	static_assert(index<layout<u32, 8>>(new_generation<layout<u32, 8>>(0x00ff'fffe)) == 0x00ff'fffe);
+	static_assert(generation<layout<u32, 8>>(new_generation<layout<u32, 8>>(0x0000'0005)) == 1);
+	static_assert(index<layout<u64, 32>>(new_generation<layout<u64, 32>>(0x0000'0000'ffff'fffe)) == 0xffff'fffe);
+	static_assert(!can_recycle<layout<u32, 8>>(layout<u32, 8>::max_generation << 24));
+	static_assert(can_add_slots<layout<u32, 8>>(0x00ff'fffe) && !can_add_slots<layout<u32, 8>>(0x00ff'ffff));
+
 #if _DEBUG
 	namespace detail {
 		struct id_base {
@@ -0,0 +1,386 @@
+#include "Animation.h"
+#include "Transform.h"
+#include "../Core/WorldSnapshot.h"
+#include <cmath>
+
+namespace revengine::animation {
+	// Anonymous namespace
+	namespace {
+		// Tracks are kept in dense arrays with one entry per track, and found through id_mapping (double-indexing).
+		// The keyframes of all tracks share one array, and each track has a range in it
+		utl::vector<id::id_type> owners; // The grievance index of each track
+		utl::vector<f32> times;
+		utl::vector<f32> speeds;
+		utl::vector<f32> durations;
+		utl::vector<u32> first_keyframes;
+		utl::vector<u32> keyframe_counts;
+		utl::vector<u32> segments; // The keyframe each track was at the last time it was sampled
+		utl::vector<wrap_mode> wraps;
+		utl::vector<u8> channels;
+		utl::vector<u8> playing;
+		utl::vector<animation_id> track_ids;
+
+		utl::vector<keyframe> keyframes;
+		u32 dead_keyframes{ 0 }; // Keyframes of removed tracks, until the keyframe array is compacted
+
+		utl::vector<id::id_type> id_mapping;
+		utl::vector<id::generation_type> generations;
+		utl::deque<animation_id> free_ids;
+
+		// Scratch arrays for sampling, kept around to avoid reallocating - one entry per playing track
+		utl::vector<u32> sample_tracks;
+		utl::vector<u32> sample_from;
+		utl::vector<u32> sample_to;
+		utl::vector<f32> sample_t;
+
+		bool exists(animation_id id) {
+			assert(id::is_valid(id));
+			const id::id_type index{ id::index(id) };
+			return index < generations.size() && generations[index] == id::generation(id) && id::is_valid(id_mapping[index]);
+		}
+
+		u32 get_track(animation_id id) {
+			assert(exists(id));
+			return (u32)id_mapping[id::index(id)];
+		}
+
+		f32 ease(f32 t, easing e) {
+			switch (e) {
+			case easing::linear: return t;
+			case easing::ease_in: return t * t;
+			case easing::ease_out: return t * (2.f - t);
+			case easing::ease_in_out: return t * t * (3.f - 2.f * t);
+			case easing::step: return 0.f;
+			}
+
+			return t;
+		}
+
+		void compact_keyframes() {
+			// Move the keyframes of the remaining tracks together, in track order
+			utl::vector<keyframe> compacted;
+			compacted.reserve(keyframes.size() - dead_keyframes);
+
+			for (u32 i{ 0 }; i < owners.size(); i++) {
+				const u32 first{ (u32)compacted.size() };
+				compacted.insert(compacted.end(), keyframes.begin() + first_keyframes[i],
+					keyframes.begin() + first_keyframes[i] + keyframe_counts[i]);
+				first_keyframes[i] = first;
+			}
+
+			keyframes.swap(compacted);
+			dead_keyframes = 0;
+		}
+
+		/// <summary>
+		/// Move the time of a track forward and wrap it, then find the keyframes around it. Tracks that play once
+		/// stop when they reach the end, after being sampled there one last time
+		/// </summary>
+		void advance(u32 track, f32 dt, u32& from, u32& to, f32& t) {
+			const f32 duration{ durations[track] };
+			f32 time{ times[track] + dt * speeds[track] };
+
+			// Get the time on the keyframes, which runs backwards on the way back of a ping pong
+			f32 local{ time };
+			switch (wraps[track]) {
+			case wrap_mode::once:
+				time = std::min(std::max(time, 0.f), duration);
+				local = time;
+				if ((speeds[track] >= 0.f && time >= duration) || (speeds[track] < 0.f && time <= 0.f)) playing[track] = false;
+				break;
+			case wrap_mode::loop:
+				time = duration > 0.f ? time - std::floor(time / duration) * duration : 0.f;
+				local = time;
+				break;
+			case wrap_mode::ping_pong:
+				time = duration > 0.f ? time - std::floor(time / (2.f * duration)) * 2.f * duration : 0.f;
+				local = time <= duration ? time : 2.f * duration - time;
+				break;
+			}
+
+			times[track] = time;
+
+			// Walk from the keyframe of the last update, which is usually the right one or the one next to it
+			const keyframe* const k{ &keyframes[first_keyframes[track]] };
+			const u32 count{ keyframe_counts[track] };
+			u32 segment{ std::min(segments[track], count - 1) };
+			while (segment > 0 && k[segment].time > local) --segment;
+			while (segment + 1 < count && k[segment + 1].time <= local) ++segment;
+			segments[track] = segment;
+
+			from = first_keyframes[track] + segment;
+			if (segment + 1 >= count) {
+				// Hold the last keyframe
+				to = from;
+				t = 0.f;
+				return;
+			}
+
+			to = from + 1;
+			const f32 length{ k[segment + 1].time - k[segment].time };
+			t = ease(length > 0.f ? (local - k[segment].time) / length : 1.f, k[segment].ease);
+		}
+
+		void sample(transform::data_view data) {
+			using namespace DirectX;
+			const u32 count{ (u32)sample_tracks.size() };
+
+			// Pad the samples to a multiple of four by repeating the last one, so that every group fills a whole vector
+			while (sample_tracks.size() % 4) {
+				sample_tracks.push_back(sample_tracks.back());
+				sample_from.push_back(sample_from.back());
+				sample_to.push_back(sample_to.back());
+				sample_t.push_back(sample_t.back());
+			}
+
+			const XMVECTOR zero{ XMVectorZero() };
+			const XMVECTOR one{ XMVectorReplicate(1.f) };
+			const XMVECTOR epsilon{ XMVectorReplicate(1e-4f) };
+
+			for (u32 i{ 0 }; i < count; i += 4) {
+				// Each lane of a vector holds one track
+				const keyframe& a0{ keyframes[sample_from[i]] };
+				const keyframe& a1{ keyframes[sample_from[i + 1]] };
+				const keyframe& a2{ keyframes[sample_from[i + 2]] };
+				const keyframe& a3{ keyframes[sample_from[i + 3]] };
+				const keyframe& b0{ keyframes[sample_to[i]] };
+				const keyframe& b1{ keyframes[sample_to[i + 1]] };
+				const keyframe& b2{ keyframes[sample_to[i + 2]] };
+				const keyframe& b3{ keyframes[sample_to[i + 3]] };
+				const XMVECTOR t{ XMVectorSet(sample_t[i], sample_t[i + 1], sample_t[i + 2], sample_t[i + 3]) };
+
+				// Lerp positions and scales
+				XMFLOAT4A position[3];
+				XMFLOAT4A scale[3];
+				for (u32 c{ 0 }; c < 3; c++) {
+					const XMVECTOR pa{ XMVectorSet(a0.position[c], a1.position[c], a2.position[c], a3.position[c]) };
+					const XMVECTOR pb{ XMVectorSet(b0.position[c], b1.position[c], b2.position[c], b3.position[c]) };
+					XMStoreFloat4A(&position[c], XMVectorMultiplyAdd(XMVectorSubtract(pb, pa), t, pa));
+
+					const XMVECTOR sa{ XMVectorSet(a0.scale[c], a1.scale[c], a2.scale[c], a3.scale[c]) };
+					const XMVECTOR sb{ XMVectorSet(b0.scale[c], b1.scale[c], b2.scale[c], b3.scale[c]) };
+					XMStoreFloat4A(&scale[c], XMVectorMultiplyAdd(XMVectorSubtract(sb, sa), t, sa));
+				}
+
+				// Slerp rotations
+				XMVECTOR qa[4];
+				XMVECTOR qb[4];
+				XMVECTOR dot{ zero };
+				for (u32 c{ 0 }; c < 4; c++) {
+					qa[c] = XMVectorSet(a0.rotation[c], a1.rotation[c], a2.rotation[c], a3.rotation[c]);
+					qb[c] = XMVectorSet(b0.rotation[c], b1.rotation[c], b2.rotation[c], b3.rotation[c]);
+					dot = XMVectorMultiplyAdd(qa[c], qb[c], dot);
+				}
+
+				// q and -q are the same rotation, so flip the second one to take the short way around
+				const XMVECTOR flip{ XMVectorLess(dot, zero) };
+				for (u32 c{ 0 }; c < 4; c++) qb[c] = XMVectorSelect(qb[c], XMVectorNegate(qb[c]), flip);
+				dot = XMVectorMin(XMVectorAbs(dot), one);
+
+				const XMVECTOR theta{ XMVectorACos(dot) };
+				const XMVECTOR sin_theta{ XMVectorSin(theta) };
+				const XMVECTOR one_minus_t{ XMVectorSubtract(one, t) };
+
+				// Fall back to lerp when the rotations are almost the same, where the slerp weights divide by almost 0
+				const XMVECTOR close{ XMVectorLess(sin_theta, epsilon) };
+				const XMVECTOR wa{ XMVectorSelect(XMVectorDivide(XMVectorSin(XMVectorMultiply(one_minus_t, theta)), sin_theta), one_minus_t, close) };
+				const XMVECTOR wb{ XMVectorSelect(XMVectorDivide(XMVectorSin(XMVectorMultiply(t, theta)), sin_theta), t, close) };
+
+				XMVECTOR q[4];
+				XMVECTOR length_sq{ zero };
+				for (u32 c{ 0 }; c < 4; c++) {
+					q[c] = XMVectorMultiplyAdd(qa[c], wa, XMVectorMultiply(qb[c], wb));
+					length_sq = XMVectorMultiplyAdd(q[c], q[c], length_sq);
+				}
+
+				// Normalize, as the lerp fallback shortens the quaternion a little
+				const XMVECTOR inverse_length{ XMVectorReciprocalSqrt(length_sq) };
+				XMFLOAT4A rotation[4];
+				for (u32 c{ 0 }; c < 4; c++) XMStoreFloat4A(&rotation[c], XMVectorMultiply(q[c], inverse_length));
+
+				// Write the results into the transform arrays
+				const u32 lanes{ std::min(4u, count - i) };
+				for (u32 lane{ 0 }; lane < lanes; lane++) {
+					const u32 track{ sample_tracks[i + lane] };
+					const id::id_type slot{ data.slots[owners[track]] };
+					assert(id::is_valid(slot));
+
+					const u8 mask{ channels[track] };
+					if (mask & channel::position) {
+						data.positions[slot] = { (&position[0].x)[lane], (&position[1].x)[lane], (&position[2].x)[lane] };
+					}
+					if (mask & channel::rotation) {
+						data.rotations[slot] = { (&rotation[0].x)[lane], (&rotation[1].x)[lane], (&rotation[2].x)[lane], (&rotation[3].x)[lane] };
+					}
+					if (mask & channel::scale) {
+						data.scales[slot] = { (&scale[0].x)[lane], (&scale[1].x)[lane], (&scale[2].x)[lane] };
+					}
+				}
+			}
+		}
+	}
+
+	motivator create(const init_info& info, grievance::grievance grievance) {
+		assert(grievance.is_valid());
+		assert(info.keyframes && info.keyframe_count);
+
+		animation_id id{};
+		if (free_ids.size() > id::min_deleted_elements) {
+			// Get an id from the front and increase its generation
+			id = free_ids.front();
+			assert(!exists(id));
+			free_ids.pop_front();
+			id = animation_id{ id::new_generation(id) };
+			++generations[id::index(id)];
+		}
+		else {
+			// Stop before the index runs into the generation bits
+			if (!id::can_add_slots(id_mapping.size())) {
+				assert(!"Out of animation IDs");
+				return motivator{};
+			}
+
+			// Add another ID at the end of id_mapping and generations
+			id = animation_id{ (id::id_type)id_mapping.size() };
+			id_mapping.emplace_back();
+			generations.push_back(0);
+		}
+
+		// Copy the keyframes to the end of the shared array
+		const u32 first{ (u32)keyframes.size() };
+		keyframes.insert(keyframes.end(), info.keyframes, info.keyframes + info.keyframe_count);
+		assert(keyframes[first].time == 0.f);
+
+		owners.push_back(id::index(grievance.get_id()));
+		times.push_back(0.f);
+		speeds.push_back(info.speed);
+		durations.push_back(keyframes.back().time);
+		first_keyframes.push_back(first);
+		keyframe_counts.push_back(info.keyframe_count);
+		segments.push_back(0);
+		wraps.push_back(info.wrap);
+		channels.push_back(info.channels);
+		playing.push_back(true);
+		track_ids.push_back(id);
+
+		id_mapping[id::index(id)] = (id::id_type)owners.size() - 1;
+		return motivator{ id };
+	}
+
+	void remove(motivator m) {
+		assert(m.is_valid() && exists(m.get_id()));
+		const animation_id id{ m.get_id() };
+		const u32 track{ get_track(id) };
+		const animation_id last_id{ track_ids.back() };
+
+		dead_keyframes += keyframe_counts[track];
+
+		// Swap the track with the last one and remove it
+		utl::erase_unordered(owners, track);
+		utl::erase_unordered(times, track);
+		utl::erase_unordered(speeds, track);
+		utl::erase_unordered(durations, track);
+		utl::erase_unordered(first_keyframes, track);
+		utl::erase_unordered(keyframe_counts, track);
+		utl::erase_unordered(segments, track);
+		utl::erase_unordered(wraps, track);
+		utl::erase_unordered(channels, track);
+		utl::erase_unordered(playing, track);
+		utl::erase_unordered(track_ids, track);
+
+		// Point the mapping of the moved track at its new place
+		id_mapping[id::index(last_id)] = track;
+		id_mapping[id::index(id)] = id::invalid_id;
+
+		// Recycle the ID, unless the slot has used up all of its generations
+		if (id::can_recycle(id)) free_ids.push_back(id);
+
+		// Drop the keyframes of removed tracks once they take up more than half of the array
+		if (dead_keyframes > keyframes.size() / 2) compact_keyframes();
+	}
+
+	void update(f32 dt) {
+		// A packed world isn't simulated, so its tracks don't advance either
+		if (transform::is_packed()) return;
+
+		sample_tracks.clear();
+		sample_from.clear();
+		sample_to.clear();
+		sample_t.clear();
+
+		// Advance the tracks, and remember which keyframes to blend for each of them
+		const u32 count{ (u32)owners.size() };
+		for (u32 track{ 0 }; track < count; track++) {
+			if (!playing[track]) continue;
+
+			u32 from, to;
+			f32 t;
+			advance(track, dt, from, to, t);
+
+			sample_tracks.push_back(track);
+			sample_from.push_back(from);
+			sample_to.push_back(to);
+			sample_t.push_back(t);
+		}
+
+		if (!sample_tracks.empty()) sample(transform::get_data());
+	}
+
+	void capture_state(snapshot::writer& w) {
+		w.write(owners);
+		w.write(times);
+		w.write(speeds);
+		w.write(durations);
+		w.write(first_keyframes);
+		w.write(keyframe_counts);
+		w.write(segments);
+		w.write(wraps);
+		w.write(channels);
+		w.write(playing);
+		w.write(track_ids);
+		w.write(keyframes);
+		w.write_value(dead_keyframes);
+		w.write(id_mapping);
+		w.write(generations);
+		w.write(free_ids);
+	}
+
+	void restore_state(snapshot::reader& r) {
+		r.read(owners);
+		r.read(times);
+		r.read(speeds);
+		r.read(durations);
+		r.read(first_keyframes);
+		r.read(keyframe_counts);
+		r.read(segments);
+		r.read(wraps);
+		r.read(channels);
+		r.read(playing);
+		r.read(track_ids);
+		r.read(keyframes);
+		r.read_value(dead_keyframes);
+		r.read(id_mapping);
+		r.read(generations);
+		r.read(free_ids);
+	}
+
+	f32 motivator::time() const {
+		return times[get_track(_id)];
+	}
+
+	bool motivator::is_playing() const {
+		return playing[get_track(_id)];
+	}
+
+	void motivator::set_speed(f32 speed) const {
+		const u32 track{ get_track(_id) };
+		speeds[track] = speed;
+		playing[track] = true;
+	}
+
+	void motivator::set_time(f32 time) const {
+		const u32 track{ get_track(_id) };
+		times[track] = std::min(std::max(time, 0.f), durations[track]);
+		playing[track] = true;
+	}
+}
\ No newline at end of file
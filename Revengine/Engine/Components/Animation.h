@@ -0,0 +1,57 @@
+#pragma once
+#include "ComponentsCommon.h"
+
+namespace revengine::animation {
+	// An animation track moves its grievance's transform along keyframes. All tracks are sampled together in update(),
+	// four at a time with SIMD, and the results are written straight into the transform arrays. Rotations between
+	// keyframes are interpolated with slerp, and positions and scales with lerp. A tween is a track with two keyframes.
+	enum class easing : u8 {
+		linear,
+		ease_in,
+		ease_out,
+		ease_in_out,
+		step, // Hold the keyframe until the next one
+	};
+
+	enum class wrap_mode : u8 {
+		once, // Stop at the last keyframe
+		loop,
+		ping_pong,
+	};
+
+	enum channel : u8 {
+		position = 0x01,
+		rotation = 0x02,
+		scale = 0x04,
+		all = position | rotation | scale,
+	};
+
+	struct keyframe {
+		f32 time{ 0.f };
+		f32 position[3]{};
+		f32 rotation[4]{ 0.f, 0.f, 0.f, 1.f }; // Rotation quaternion
+		f32 scale[3]{ 1.f, 1.f, 1.f };
+		easing ease{ easing::linear }; // How to get from this keyframe to the next one
+	};
+
+	struct init_info {
+		const keyframe* keyframes{ nullptr }; // Ordered by time - the keyframes are copied
+		u32 keyframe_count{ 0 };
+		wrap_mode wrap{ wrap_mode::once };
+		u8 channels{ channel::all }; // The parts of the transform that the track writes to
+		f32 speed{ 1.f };
+	};
+
+	motivator create(const init_info& info, grievance::grievance grievance);
+	void remove(motivator m);
+
+	/// <summary>
+	/// Advance every playing track and write the sampled transforms into the transform arrays. Tracks that
+	/// aren't playing are skipped
+	/// </summary>
+	/// <param name="dt">The time since the last update, in seconds</param>
+	void update(f32 dt);
+
+	void capture_state(snapshot::writer& w);
+	void restore_state(snapshot::reader& r);
+}
\ No newline at end of file
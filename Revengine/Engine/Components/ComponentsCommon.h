@@ -1,4 +1,9 @@
 #pragma once
-#include "..\Common\CommonHeaders.h"
-#include "..\Common\Id.h"
-#include "..\EngineAPI\Grievance.h"
\ No newline at end of file
+#include "../Common/CommonHeaders.h"
+#include "../Common/Id.h"
+#include "../EngineAPI/Grievance.h"
+
+namespace revengine::snapshot {
+	class writer;
+	class reader;
+}
\ No newline at end of file
@@ -1,14 +1,27 @@
 #include "Grievance.h"
 #include "Transform.h"
 #include "Script.h"
+#include "Animation.h"
+#include "Motion.h"
+#include "Renderable.h"
+#include "Lifetime.h"
+#include "../Core/WorldSnapshot.h"
 
 namespace revengine::grievance {
 	// Anonymous namespace
 	namespace {
 		utl::vector<transform::motivator> transforms;
 		utl::vector<script::motivator> scripts;
+		utl::vector<animation::motivator> animations;
+		utl::vector<motion::motivator> motions;
+		utl::vector<renderable::motivator> renderables;
+		utl::vector<lifetime::motivator> lifetimes;
 		utl::vector<id::generation_type> generations;
 		utl::deque<grievance_id> free_ids;
+
+		// Scratch arrays for create_batch(), kept around to avoid reallocating
+		utl::vector<transform::motivator> batch_transforms;
+		utl::vector<script::motivator> batch_scripts;
 	}
 
 
@@ -37,6 +50,12 @@ namespace revengine::grievance {
 			++generations[id::index(id)];
 		}
 		else {
+			// Stop before the index runs into the generation bits
+			if (!id::can_add_slots(generations.size())) {
+				assert(!"Out of grievance IDs");
+				return grievance{};
+			}
+
 			// Add a new element to the end of the list of grievances
 			id = grievance_id{ (id::id_type)generations.size() };
 			generations.push_back(0);
@@ -47,6 +66,10 @@ namespace revengine::grievance {
 			//		  to resize by 1 every time
 			transforms.emplace_back();
 			scripts.emplace_back();
+			animations.emplace_back();
+			motions.emplace_back();
+			renderables.emplace_back();
+			lifetimes.emplace_back();
 		}
 
 		// Assign the ID to the new grievance
@@ -74,16 +97,157 @@ namespace revengine::grievance {
 			assert(scripts[index].is_valid());
 		}
 
+		// Create animation motivator if there are keyframes to play
+		if (info.animation && info.animation->keyframe_count) {
+			assert(!animations[index].is_valid());
+			animations[index] = animation::create(*info.animation, new_grievance);
+		}
+
+		// Create motion motivator if the grievance moves on its own
+		if (info.motion) {
+			assert(!motions[index].is_valid());
+			motions[index] = motion::create(*info.motion, new_grievance);
+		}
+
+		// Create renderable motivator if the grievance can be drawn
+		if (info.renderable) {
+			assert(!renderables[index].is_valid());
+			renderables[index] = renderable::create(*info.renderable, new_grievance);
+		}
+
+		// Create lifetime motivator if the grievance removes itself after a while
+		if (info.lifetime) {
+			assert(!lifetimes[index].is_valid());
+			lifetimes[index] = lifetime::create(*info.lifetime, new_grievance);
+		}
+
 		// Return the new grievance
 		return new_grievance;
 	}
 
+	void create_batch(const grievance_info& info, const transform::batch_info& batch, u32 count, grievance_id* ids) {
+		// Make sure all Grievances have a transform component
+		assert(info.transform);
+		if (!info.transform || !count) return;
+
+		// Take recycled IDs while there are enough of them
+		u32 recycled{ 0 };
+		for (; recycled < count && free_ids.size() > id::min_deleted_elements; recycled++) {
+			grievance_id id{ free_ids.front() };
+			assert(!is_alive(id));
+			free_ids.pop_front();
+
+			id = grievance_id{ id::new_generation(id) };
+			++generations[id::index(id)];
+			ids[recycled] = id;
+		}
+
+		// Add slots for the rest at the end of the arrays in one go
+		const id::id_type first{ (id::id_type)generations.size() };
+		u32 added{ count - recycled };
+
+		// Stop before the indices run into the generation bits, and leave the grievances that don't fit uncreated
+		if (!id::can_add_slots(first, added)) {
+			assert(!"Out of grievance IDs");
+			added = first < id::detail::index_mask ? (u32)(id::detail::index_mask - first) : 0;
+			for (u32 i{ recycled + added }; i < count; i++) ids[i] = grievance_id{ id::invalid_id };
+			count = recycled + added;
+		}
+
+		generations.resize(first + added, 0);
+		transforms.resize(first + added);
+		scripts.resize(first + added);
+		animations.resize(first + added);
+		motions.resize(first + added);
+		renderables.resize(first + added);
+		lifetimes.resize(first + added);
+
+		for (u32 i{ recycled }; i < count; i++) ids[i] = grievance_id{ first + i - recycled };
+
+		// Create the components of the whole batch with one call per component
+		batch_transforms.resize(count);
+		transform::create_batch(*info.transform, batch, ids, count, batch_transforms.data());
+
+		for (u32 i{ 0 }; i < count; i++) {
+			const id::id_type index{ id::index(ids[i]) };
+			assert(!transforms[index].is_valid() && batch_transforms[i].is_valid());
+			transforms[index] = batch_transforms[i];
+		}
+
+		if (info.script && info.script->script_creator) {
+			batch_scripts.resize(count);
+			script::create_batch(*info.script, ids, count, batch_scripts.data());
+
+			for (u32 i{ 0 }; i < count; i++) {
+				const id::id_type index{ id::index(ids[i]) };
+				assert(!scripts[index].is_valid() && batch_scripts[i].is_valid());
+				scripts[index] = batch_scripts[i];
+			}
+		}
+
+		if (info.animation && info.animation->keyframe_count) {
+			for (u32 i{ 0 }; i < count; i++) {
+				const id::id_type index{ id::index(ids[i]) };
+				assert(!animations[index].is_valid());
+				animations[index] = animation::create(*info.animation, grievance{ ids[i] });
+			}
+		}
+
+		if (info.motion) {
+			for (u32 i{ 0 }; i < count; i++) {
+				const id::id_type index{ id::index(ids[i]) };
+				assert(!motions[index].is_valid());
+				motions[index] = motion::create(*info.motion, grievance{ ids[i] });
+			}
+		}
+
+		if (info.renderable) {
+			for (u32 i{ 0 }; i < count; i++) {
+				const id::id_type index{ id::index(ids[i]) };
+				assert(!renderables[index].is_valid());
+				renderables[index] = renderable::create(*info.renderable, grievance{ ids[i] });
+			}
+		}
+
+		if (info.lifetime) {
+			for (u32 i{ 0 }; i < count; i++) {
+				const id::id_type index{ id::index(ids[i]) };
+				assert(!lifetimes[index].is_valid());
+				lifetimes[index] = lifetime::create(*info.lifetime, grievance{ ids[i] });
+			}
+		}
+	}
+
 	void remove(grievance_id id) {
 		const id::id_type index{ id::index(id) };
 
 		// Confirm if the grievance is alive
 		assert(is_alive(id));
 
+		// Remove lifetimes
+		if (lifetimes[index].is_valid()) {
+			lifetime::remove(lifetimes[index]);
+			lifetimes[index] = {};
+		}
+
+		// Remove renderables
+		if (renderables[index].is_valid()) {
+			renderable::remove(renderables[index]);
+			renderables[index] = {};
+		}
+
+		// Remove motion
+		if (motions[index].is_valid()) {
+			motion::remove(motions[index]);
+			motions[index] = {};
+		}
+
+		// Remove animations
+		if (animations[index].is_valid()) {
+			animation::remove(animations[index]);
+			animations[index] = {};
+		}
+
 		// Remove scripts
 		if (scripts[index].is_valid()) {
 			script::remove(scripts[index]);
@@ -96,8 +260,9 @@ namespace revengine::grievance {
 		// Put a default component in that slot
 		transforms[index] = {};
 
-		// Push back the ID
-		free_ids.push_back(id);
+		// Push back the ID, unless the slot has used up all of its generations - then it is retired, so
+		// that the generation never wraps around and old IDs can't alias new grievances
+		if (id::can_recycle(id)) free_ids.push_back(id);
 	}
 
 	bool is_alive(grievance_id id) {
@@ -116,6 +281,32 @@ namespace revengine::grievance {
 		return (generations[index] == id::generation(id) && transforms[index].is_valid());
 	}
 
+	data_view get_data() {
+		return { generations.data(), (u32)generations.size() };
+	}
+
+	void capture_state(snapshot::writer& w) {
+		w.write(generations);
+		w.write(free_ids);
+		w.write(transforms);
+		w.write(scripts);
+		w.write(animations);
+		w.write(motions);
+		w.write(renderables);
+		w.write(lifetimes);
+	}
+
+	void restore_state(snapshot::reader& r) {
+		r.read(generations);
+		r.read(free_ids);
+		r.read(transforms);
+		r.read(scripts);
+		r.read(animations);
+		r.read(motions);
+		r.read(renderables);
+		r.read(lifetimes);
+	}
+
 	transform::motivator grievance::transform() const {
 		// Confirm that the grievance is alive
 		assert(is_alive(_id));
@@ -137,4 +328,48 @@ namespace revengine::grievance {
 		// Return the transform at that index
 		return scripts[index];
 	}
+
+	animation::motivator grievance::animation() const {
+		// Confirm that the grievance is alive
+		assert(is_alive(_id));
+
+		// Get the index of the grievance
+		const id::id_type index{ id::index(_id) };
+
+		// Return the animation at that index
+		return animations[index];
+	}
+
+	motion::motivator grievance::motion() const {
+		// Confirm that the grievance is alive
+		assert(is_alive(_id));
+
+		// Get the index of the grievance
+		const id::id_type index{ id::index(_id) };
+
+		// Return the motion at that index
+		return motions[index];
+	}
+
+	renderable::motivator grievance::renderable() const {
+		// Confirm that the grievance is alive
+		assert(is_alive(_id));
+
+		// Get the index of the grievance
+		const id::id_type index{ id::index(_id) };
+
+		// Return the renderable at that index
+		return renderables[index];
+	}
+
+	lifetime::motivator grievance::lifetime() const {
+		// Confirm that the grievance is alive
+		assert(is_alive(_id));
+
+		// Get the index of the grievance
+		const id::id_type index{ id::index(_id) };
+
+		// Return the lifetime at that index
+		return lifetimes[index];
+	}
 }
\ No newline at end of file
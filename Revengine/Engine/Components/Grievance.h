@@ -8,17 +8,48 @@ namespace revengine {
 
 		INIT_INFO(transform);
 		INIT_INFO(script);
+		INIT_INFO(animation);
+		INIT_INFO(motion);
+		INIT_INFO(renderable);
+		INIT_INFO(lifetime);
 
 #undef INIT_INFO // End the forward declaration after using it - prevents further pollution of header files
 
+	namespace transform { struct batch_info; }
+
 	namespace grievance {
 		struct grievance_info {
 			transform::init_info* transform{ nullptr };
 			script::init_info* script{ nullptr };
+			animation::init_info* animation{ nullptr };
+			motion::init_info* motion{ nullptr }; // Leave null for grievances that don't move on their own
+			renderable::init_info* renderable{ nullptr };
+			lifetime::init_info* lifetime{ nullptr }; // Leave null for grievances that stay until they're removed
 		};
 
 		grievance create(const grievance_info& info);
+
+		/// <summary>
+		/// Create many grievances that share the same components. Each component array is grown once for the whole batch
+		/// </summary>
+		/// <param name="info">The components of every grievance</param>
+		/// <param name="batch">The transform values that differ per grievance</param>
+		/// <param name="count">The amount of grievances to create</param>
+		/// <param name="ids">The array to write the IDs of the new grievances to</param>
+		void create_batch(const grievance_info& info, const transform::batch_info& batch, u32 count, grievance_id* ids);
 		void remove(grievance_id id);
 		bool is_alive(grievance_id id);
+
+		// The current generation of each grievance index, for systems that keep their own state per grievance index and
+		// need to tell when an index was reused. The pointer stays valid until a grievance is created
+		struct data_view {
+			const id::generation_type* generations;
+			u32 count;
+		};
+
+		data_view get_data();
+
+		void capture_state(snapshot::writer& w);
+		void restore_state(snapshot::reader& r);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "Lifetime.h"
+#include "Grievance.h"
+#include "../Core/WorldSnapshot.h"
+#include <cmath>
+
+namespace revengine::lifetime {
+	// Anonymous namespace
+	namespace {
+		// The wheel has levels of 256 slots. Level 0 has a slot per tick, and every slot of the next level covers a whole
+		// turn of the level below it. A lifetime goes into the lowest level that reaches its expiry tick, and moves down a
+		// level each time the wheel gets to its slot there, until it runs out in level 0
+		constexpr u32 slot_bits{ 8 };
+		constexpr u32 slot_count{ 1 << slot_bits };
+		constexpr u32 level_count{ 4 };
+		constexpr u64 max_ticks{ (1ull << (slot_bits * level_count)) - 1 }; // About two years, longer lifetimes are cut to that
+
+		// Lifetimes are kept in dense arrays, and found through id_mapping (double-indexing). Each slot of the wheel
+		// is a doubly linked list through prev and next
+		utl::vector<grievance::grievance_id> owners;
+		utl::vector<u64> expiries; // The tick at which each lifetime runs out
+		utl::vector<u32> prev;
+		utl::vector<u32> next;
+		utl::vector<u32> slots; // The wheel slot of each lifetime, or invalid_id if it's not in the wheel
+		utl::vector<lifetime_id> lifetime_ids;
+
+		utl::vector<id::id_type> id_mapping;
+		utl::vector<id::generation_type> generations;
+		utl::deque<lifetime_id> free_ids;
+
+		utl::vector<u32> heads(level_count * slot_count, u32_invalid_id); // The first lifetime in each slot
+		u64 current_tick{ 0 };
+		f32 accumulated{ 0.f }; // Time that didn't make up a whole tick yet
+
+		// Scratch array for update(), kept around to avoid reallocating
+		utl::vector<grievance::grievance_id> expired;
+
+		bool exists(lifetime_id id) {
+			assert(id::is_valid(id));
+			const id::id_type index{ id::index(id) };
+			return index < generations.size() && generations[index] == id::generation(id) && id::is_valid(id_mapping[index]);
+		}
+
+		u32 get_entry(lifetime_id id) {
+			assert(exists(id));
+			return (u32)id_mapping[id::index(id)];
+		}
+
+		void link(u32 entry, u32 slot) {
+			prev[entry] = u32_invalid_id;
+			next[entry] = heads[slot];
+			if (next[entry] != u32_invalid_id) prev[next[entry]] = entry;
+			heads[slot] = entry;
+			slots[entry] = slot;
+		}
+
+		void unlink(u32 entry) {
+			if (slots[entry] == u32_invalid_id) return;
+
+			if (prev[entry] != u32_invalid_id) next[prev[entry]] = next[entry];
+			else heads[slots[entry]] = next[entry];
+			if (next[entry] != u32_invalid_id) prev[next[entry]] = prev[entry];
+			slots[entry] = u32_invalid_id;
+		}
+
+		void schedule(u32 entry) {
+			assert(expiries[entry] >= current_tick);
+			const u64 delta{ expiries[entry] - current_tick };
+
+			u32 level{ 0 };
+			while (level < level_count - 1 && delta >> (slot_bits * (level + 1))) ++level;
+
+			const u32 slot{ (u32)(expiries[entry] >> (slot_bits * level)) & (slot_count - 1) };
+			link(entry, level * slot_count + slot);
+		}
+
+		u64 ticks_for(f32 seconds) {
+			// Always at least one tick, so that a lifetime never runs out in the same update it was created
+			const f32 ticks{ std::ceil(seconds / tick_length) };
+			return ticks < 1.f ? 1 : ticks >= (f32)max_ticks ? max_ticks : (u64)ticks;
+		}
+
+		void advance() {
+			++current_tick;
+
+			// Move the lifetimes of the slots the wheel reached on the higher levels down, highest level first
+			for (u32 level{ level_count - 1 }; level > 0; level--) {
+				const u32 shift{ slot_bits * level };
+				if (current_tick & ((1ull << shift) - 1)) continue;
+
+				const u32 slot{ level * slot_count + ((u32)(current_tick >> shift) & (slot_count - 1)) };
+				u32 entry{ heads[slot] };
+				heads[slot] = u32_invalid_id;
+
+				while (entry != u32_invalid_id) {
+					const u32 following{ next[entry] };
+					slots[entry] = u32_invalid_id;
+					schedule(entry);
+					entry = following;
+				}
+			}
+
+			// Everything in the level 0 slot runs out now
+			const u32 slot{ (u32)current_tick & (slot_count - 1) };
+			u32 entry{ heads[slot] };
+			heads[slot] = u32_invalid_id;
+
+			while (entry != u32_invalid_id) {
+				assert(expiries[entry] == current_tick);
+				const u32 following{ next[entry] };
+				slots[entry] = u32_invalid_id;
+				expired.push_back(owners[entry]);
+				entry = following;
+			}
+		}
+	}
+
+	motivator create(const init_info& info, grievance::grievance grievance) {
+		assert(grievance.is_valid());
+
+		lifetime_id id{};
+		if (free_ids.size() > id::min_deleted_elements) {
+			// Get an id from the front and increase its generation
+			id = free_ids.front();
+			assert(!exists(id));
+			free_ids.pop_front();
+			id = lifetime_id{ id::new_generation(id) };
+			++generations[id::index(id)];
+		}
+		else {
+			// Stop before the index runs into the generation bits
+			if (!id::can_add_slots(id_mapping.size())) {
+				assert(!"Out of lifetime IDs");
+				return motivator{};
+			}
+
+			// Add another ID at the end of id_mapping and generations
+			id = lifetime_id{ (id::id_type)id_mapping.size() };
+			id_mapping.emplace_back();
+			generations.push_back(0);
+		}
+
+		const u32 entry{ (u32)owners.size() };
+		owners.push_back(grievance.get_id());
+		expiries.push_back(current_tick + ticks_for(info.seconds));
+		prev.push_back(u32_invalid_id);
+		next.push_back(u32_invalid_id);
+		slots.push_back(u32_invalid_id);
+		lifetime_ids.push_back(id);
+		schedule(entry);
+
+		id_mapping[id::index(id)] = entry;
+		return motivator{ id };
+	}
+
+	void remove(motivator m) {
+		assert(m.is_valid() && exists(m.get_id()));
+		const lifetime_id id{ m.get_id() };
+		const u32 entry{ get_entry(id) };
+		const u32 last{ (u32)owners.size() - 1 };
+		const lifetime_id last_id{ lifetime_ids.back() };
+
+		unlink(entry);
+
+		// Move the last lifetime into the entry, and point its neighbours in the wheel at its new place
+		if (entry != last) {
+			owners[entry] = owners[last];
+			expiries[entry] = expiries[last];
+			prev[entry] = prev[last];
+			next[entry] = next[last];
+			slots[entry] = slots[last];
+			lifetime_ids[entry] = last_id;
+
+			if (slots[entry] != u32_invalid_id) {
+				if (prev[entry] != u32_invalid_id) next[prev[entry]] = entry;
+				else heads[slots[entry]] = entry;
+				if (next[entry] != u32_invalid_id) prev[next[entry]] = entry;
+			}
+		}
+
+		owners.pop_back();
+		expiries.pop_back();
+		prev.pop_back();
+		next.pop_back();
+		slots.pop_back();
+		lifetime_ids.pop_back();
+
+		id_mapping[id::index(last_id)] = entry;
+		id_mapping[id::index(id)] = id::invalid_id;
+
+		// Recycle the ID, unless the slot has used up all of its generations
+		if (id::can_recycle(id)) free_ids.push_back(id);
+	}
+
+	u32 update(f32 dt) {
+		accumulated += dt;
+		while (accumulated >= tick_length) {
+			accumulated -= tick_length;
+			advance();
+		}
+
+		// Remove the grievances after the wheel is done, through the same path as any other removal. Removing a
+		// grievance removes its lifetime component, which isn't in the wheel anymore
+		const u32 count{ (u32)expired.size() };
+		for (u32 i{ 0 }; i < count; i++) grievance::remove(expired[i]);
+		expired.clear();
+		return count;
+	}
+
+	void capture_state(snapshot::writer& w) {
+		w.write(owners);
+		w.write(expiries);
+		w.write(prev);
+		w.write(next);
+		w.write(slots);
+		w.write(lifetime_ids);
+		w.write(id_mapping);
+		w.write(generations);
+		w.write(free_ids);
+		w.write(heads);
+		w.write_value(current_tick);
+		w.write_value(accumulated);
+	}
+
+	void restore_state(snapshot::reader& r) {
+		r.read(owners);
+		r.read(expiries);
+		r.read(prev);
+		r.read(next);
+		r.read(slots);
+		r.read(lifetime_ids);
+		r.read(id_mapping);
+		r.read(generations);
+		r.read(free_ids);
+		r.read(heads);
+		r.read_value(current_tick);
+		r.read_value(accumulated);
+	}
+
+	f32 motivator::remaining() const {
+		const u32 entry{ get_entry(_id) };
+		return (f32)(expiries[entry] - current_tick) * tick_length - accumulated;
+	}
+
+	void motivator::set_remaining(f32 seconds) const {
+		const u32 entry{ get_entry(_id) };
+		unlink(entry);
+		expiries[entry] = current_tick + ticks_for(seconds);
+		schedule(entry);
+	}
+}
\ No newline at end of file
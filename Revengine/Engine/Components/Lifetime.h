@@ -0,0 +1,30 @@
+#pragma once
+#include "ComponentsCommon.h"
+
+namespace revengine::lifetime {
+	// Grievances with a lifetime component are removed once their time is up, like projectiles and effects. Lifetimes
+	// are kept in a hierarchical timer wheel, so adding and cancelling one takes constant time, and lifetimes that
+	// aren't close to running out cost nothing per frame.
+	constexpr f32 tick_length{ 1.f / 64.f }; // Lifetimes are rounded up to whole ticks
+
+	struct init_info {
+		f32 seconds{ 0.f }; // The time until the grievance is removed
+	};
+
+	motivator create(const init_info& info, grievance::grievance grievance);
+
+	/// <summary>
+	/// Remove the lifetime component, which cancels the removal of its grievance
+	/// </summary>
+	void remove(motivator m);
+
+	/// <summary>
+	/// Advance the timer wheel, and remove every grievance whose lifetime ran out in one pass at the end
+	/// </summary>
+	/// <param name="dt">The time step, in seconds</param>
+	/// <returns>The amount of grievances that were removed</returns>
+	u32 update(f32 dt);
+
+	void capture_state(snapshot::writer& w);
+	void restore_state(snapshot::reader& r);
+}
\ No newline at end of file
@@ -0,0 +1,289 @@
+#include "Motion.h"
+#include "Transform.h"
+#include "../Core/WorldSnapshot.h"
+
+namespace revengine::motion {
+	// Anonymous namespace
+	namespace {
+		// A vector quantity stored as one array per component
+		struct stream {
+			utl::vector<f32> x;
+			utl::vector<f32> y;
+			utl::vector<f32> z;
+
+			void push_back(const f32* v) {
+				x.push_back(v[0]);
+				y.push_back(v[1]);
+				z.push_back(v[2]);
+			}
+
+			void erase_unordered(u32 index) {
+				utl::erase_unordered(x, index);
+				utl::erase_unordered(y, index);
+				utl::erase_unordered(z, index);
+			}
+
+			math::v3 get(u32 index) const {
+				return { x[index], y[index], z[index] };
+			}
+
+			void set(u32 index, math::v3 v) {
+				x[index] = v.x;
+				y[index] = v.y;
+				z[index] = v.z;
+			}
+
+			void write(snapshot::writer& w) const {
+				w.write(x);
+				w.write(y);
+				w.write(z);
+			}
+
+			void read(snapshot::reader& r) {
+				r.read(x);
+				r.read(y);
+				r.read(z);
+			}
+		};
+
+		// Motion data is kept in dense arrays with one entry per moving grievance, and found through id_mapping (double-indexing)
+		stream linear_velocities;
+		stream linear_accelerations;
+		stream angular_velocities;
+		stream angular_accelerations;
+		utl::vector<id::id_type> owners; // The grievance index of each entry
+		utl::vector<motion_id> motion_ids;
+
+		utl::vector<id::id_type> id_mapping;
+		utl::vector<id::generation_type> generations;
+		utl::deque<motion_id> free_ids;
+
+		bool exists(motion_id id) {
+			assert(id::is_valid(id));
+			const id::id_type index{ id::index(id) };
+			return index < generations.size() && generations[index] == id::generation(id) && id::is_valid(id_mapping[index]);
+		}
+
+		u32 get_entry(motion_id id) {
+			assert(exists(id));
+			return (u32)id_mapping[id::index(id)];
+		}
+
+		void accelerate(utl::vector<f32>& velocity, const utl::vector<f32>& acceleration, f32 dt, u32 first, u32 end) {
+			// A plain loop over two arrays, which the compiler can turn into SIMD on its own
+			f32* const v{ velocity.data() };
+			const f32* const a{ acceleration.data() };
+			for (u32 i{ first }; i < end; i++) v[i] += a[i] * dt;
+		}
+	}
+
+	motivator create(const init_info& info, grievance::grievance grievance) {
+		assert(grievance.is_valid());
+
+		motion_id id{};
+		if (free_ids.size() > id::min_deleted_elements) {
+			// Get an id from the front and increase its generation
+			id = free_ids.front();
+			assert(!exists(id));
+			free_ids.pop_front();
+			id = motion_id{ id::new_generation(id) };
+			++generations[id::index(id)];
+		}
+		else {
+			// Stop before the index runs into the generation bits
+			if (!id::can_add_slots(id_mapping.size())) {
+				assert(!"Out of motion IDs");
+				return motivator{};
+			}
+
+			// Add another ID at the end of id_mapping and generations
+			id = motion_id{ (id::id_type)id_mapping.size() };
+			id_mapping.emplace_back();
+			generations.push_back(0);
+		}
+
+		linear_velocities.push_back(info.linear_velocity);
+		linear_accelerations.push_back(info.linear_acceleration);
+		angular_velocities.push_back(info.angular_velocity);
+		angular_accelerations.push_back(info.angular_acceleration);
+		owners.push_back(id::index(grievance.get_id()));
+		motion_ids.push_back(id);
+
+		id_mapping[id::index(id)] = (id::id_type)owners.size() - 1;
+		return motivator{ id };
+	}
+
+	void remove(motivator m) {
+		assert(m.is_valid() && exists(m.get_id()));
+		const motion_id id{ m.get_id() };
+		const u32 entry{ get_entry(id) };
+		const motion_id last_id{ motion_ids.back() };
+
+		// Swap the entry with the last one and remove it
+		linear_velocities.erase_unordered(entry);
+		linear_accelerations.erase_unordered(entry);
+		angular_velocities.erase_unordered(entry);
+		angular_accelerations.erase_unordered(entry);
+		utl::erase_unordered(owners, entry);
+		utl::erase_unordered(motion_ids, entry);
+
+		// Point the mapping of the moved entry at its new place
+		id_mapping[id::index(last_id)] = entry;
+		id_mapping[id::index(id)] = id::invalid_id;
+
+		// Recycle the ID, unless the slot has used up all of its generations
+		if (id::can_recycle(id)) free_ids.push_back(id);
+	}
+
+	u32 count() {
+		return (u32)owners.size();
+	}
+
+	void integrate(f32 dt, u32 first, u32 count) {
+		using namespace DirectX;
+		assert(first + count <= owners.size());
+
+		// A packed world isn't simulated
+		if (!count || transform::is_packed()) return;
+
+		const u32 end{ first + count };
+		const transform::data_view data{ transform::get_data() };
+
+		// Update the velocities first, so that positions and rotations move with the new ones (semi-implicit Euler)
+		accelerate(linear_velocities.x, linear_accelerations.x, dt, first, end);
+		accelerate(linear_velocities.y, linear_accelerations.y, dt, first, end);
+		accelerate(linear_velocities.z, linear_accelerations.z, dt, first, end);
+		accelerate(angular_velocities.x, angular_accelerations.x, dt, first, end);
+		accelerate(angular_velocities.y, angular_accelerations.y, dt, first, end);
+		accelerate(angular_velocities.z, angular_accelerations.z, dt, first, end);
+
+		const XMVECTOR step{ XMVectorReplicate(dt) };
+		const XMVECTOR half_step{ XMVectorReplicate(0.5f * dt) };
+		const XMVECTOR epsilon{ XMVectorReplicate(1e-6f) };
+		const stream& v{ linear_velocities };
+		const stream& w{ angular_velocities };
+
+		for (u32 i{ first }; i < end; i += 4) {
+			// Each lane of a vector holds one grievance. The last group repeats the last grievance to fill its lanes,
+			// which is harmless as every lane reads its transform before any lane writes
+			u32 e[4];
+			id::id_type slot[4];
+			for (u32 lane{ 0 }; lane < 4; lane++) {
+				e[lane] = std::min(i + lane, end - 1);
+				slot[lane] = data.slots[owners[e[lane]]];
+				assert(id::is_valid(slot[lane]));
+			}
+
+			const math::v3& p0{ data.positions[slot[0]] };
+			const math::v3& p1{ data.positions[slot[1]] };
+			const math::v3& p2{ data.positions[slot[2]] };
+			const math::v3& p3{ data.positions[slot[3]] };
+			const math::v4& q0{ data.rotations[slot[0]] };
+			const math::v4& q1{ data.rotations[slot[1]] };
+			const math::v4& q2{ data.rotations[slot[2]] };
+			const math::v4& q3{ data.rotations[slot[3]] };
+
+			// Move the positions along the velocities
+			XMFLOAT4A position[3];
+			XMStoreFloat4A(&position[0], XMVectorMultiplyAdd(XMVectorSet(v.x[e[0]], v.x[e[1]], v.x[e[2]], v.x[e[3]]), step, XMVectorSet(p0.x, p1.x, p2.x, p3.x)));
+			XMStoreFloat4A(&position[1], XMVectorMultiplyAdd(XMVectorSet(v.y[e[0]], v.y[e[1]], v.y[e[2]], v.y[e[3]]), step, XMVectorSet(p0.y, p1.y, p2.y, p3.y)));
+			XMStoreFloat4A(&position[2], XMVectorMultiplyAdd(XMVectorSet(v.z[e[0]], v.z[e[1]], v.z[e[2]], v.z[e[3]]), step, XMVectorSet(p0.z, p1.z, p2.z, p3.z)));
+
+			// Turn the angular velocity into the rotation of this step: the axis scaled by sin(angle / 2), and cos(angle / 2)
+			const XMVECTOR wx{ XMVectorSet(w.x[e[0]], w.x[e[1]], w.x[e[2]], w.x[e[3]]) };
+			const XMVECTOR wy{ XMVectorSet(w.y[e[0]], w.y[e[1]], w.y[e[2]], w.y[e[3]]) };
+			const XMVECTOR wz{ XMVectorSet(w.z[e[0]], w.z[e[1]], w.z[e[2]], w.z[e[3]]) };
+			const XMVECTOR speed{ XMVectorSqrt(XMVectorMultiplyAdd(wx, wx, XMVectorMultiplyAdd(wy, wy, XMVectorMultiply(wz, wz)))) };
+
+			XMVECTOR sin_half, cos_half;
+			XMVectorSinCos(&sin_half, &cos_half, XMVectorMultiply(speed, half_step));
+
+			// sin(angle / 2) / speed goes to dt / 2 for slow rotations, and is used as is to avoid dividing by 0
+			const XMVECTOR still{ XMVectorLess(speed, epsilon) };
+			const XMVECTOR scale{ XMVectorSelect(XMVectorDivide(sin_half, speed), half_step, still) };
+			const XMVECTOR dx{ XMVectorMultiply(wx, scale) };
+			const XMVECTOR dy{ XMVectorMultiply(wy, scale) };
+			const XMVECTOR dz{ XMVectorMultiply(wz, scale) };
+			const XMVECTOR dw{ cos_half };
+
+			// Apply it in world space: q' = dq * q
+			const XMVECTOR qx{ XMVectorSet(q0.x, q1.x, q2.x, q3.x) };
+			const XMVECTOR qy{ XMVectorSet(q0.y, q1.y, q2.y, q3.y) };
+			const XMVECTOR qz{ XMVectorSet(q0.z, q1.z, q2.z, q3.z) };
+			const XMVECTOR qw{ XMVectorSet(q0.w, q1.w, q2.w, q3.w) };
+
+			XMVECTOR rx{ XMVectorMultiplyAdd(dw, qx, XMVectorMultiplyAdd(dx, qw, XMVectorSubtract(XMVectorMultiply(dy, qz), XMVectorMultiply(dz, qy)))) };
+			XMVECTOR ry{ XMVectorMultiplyAdd(dw, qy, XMVectorMultiplyAdd(dy, qw, XMVectorSubtract(XMVectorMultiply(dz, qx), XMVectorMultiply(dx, qz)))) };
+			XMVECTOR rz{ XMVectorMultiplyAdd(dw, qz, XMVectorMultiplyAdd(dz, qw, XMVectorSubtract(XMVectorMultiply(dx, qy), XMVectorMultiply(dy, qx)))) };
+			XMVECTOR rw{ XMVectorSubtract(XMVectorMultiply(dw, qw), XMVectorMultiplyAdd(dx, qx, XMVectorMultiplyAdd(dy, qy, XMVectorMultiply(dz, qz)))) };
+
+			// Normalize to keep rounding errors from building up over many steps. Transforms are created with an all zero
+			// rotation by default, which stays as it is instead of turning into NaNs
+			const XMVECTOR length_sq{ XMVectorMultiplyAdd(rx, rx, XMVectorMultiplyAdd(ry, ry, XMVectorMultiplyAdd(rz, rz, XMVectorMultiply(rw, rw)))) };
+			const XMVECTOR inverse_length{ XMVectorSelect(XMVectorReciprocalSqrt(length_sq), XMVectorReplicate(1.f), XMVectorLess(length_sq, epsilon)) };
+			XMFLOAT4A rotation[4];
+			XMStoreFloat4A(&rotation[0], XMVectorMultiply(rx, inverse_length));
+			XMStoreFloat4A(&rotation[1], XMVectorMultiply(ry, inverse_length));
+			XMStoreFloat4A(&rotation[2], XMVectorMultiply(rz, inverse_length));
+			XMStoreFloat4A(&rotation[3], XMVectorMultiply(rw, inverse_length));
+
+			// Write the results back into the transform arrays
+			for (u32 lane{ 0 }; lane < 4; lane++) {
+				data.positions[slot[lane]] = { (&position[0].x)[lane], (&position[1].x)[lane], (&position[2].x)[lane] };
+				data.rotations[slot[lane]] = { (&rotation[0].x)[lane], (&rotation[1].x)[lane], (&rotation[2].x)[lane], (&rotation[3].x)[lane] };
+			}
+		}
+	}
+
+	void update(f32 dt) {
+		integrate(dt, 0, count());
+	}
+
+	void capture_state(snapshot::writer& w) {
+		linear_velocities.write(w);
+		linear_accelerations.write(w);
+		angular_velocities.write(w);
+		angular_accelerations.write(w);
+		w.write(owners);
+		w.write(motion_ids);
+		w.write(id_mapping);
+		w.write(generations);
+		w.write(free_ids);
+	}
+
+	void restore_state(snapshot::reader& r) {
+		linear_velocities.read(r);
+		linear_accelerations.read(r);
+		angular_velocities.read(r);
+		angular_accelerations.read(r);
+		r.read(owners);
+		r.read(motion_ids);
+		r.read(id_mapping);
+		r.read(generations);
+		r.read(free_ids);
+	}
+
+	math::v3 motivator::linear_velocity() const {
+		return linear_velocities.get(get_entry(_id));
+	}
+
+	math::v3 motivator::angular_velocity() const {
+		return angular_velocities.get(get_entry(_id));
+	}
+
+	void motivator::set_linear_velocity(math::v3 velocity) const {
+		linear_velocities.set(get_entry(_id), velocity);
+	}
+
+	void motivator::set_angular_velocity(math::v3 velocity) const {
+		angular_velocities.set(get_entry(_id), velocity);
+	}
+
+	void motivator::set_linear_acceleration(math::v3 acceleration) const {
+		linear_accelerations.set(get_entry(_id), acceleration);
+	}
+
+	void motivator::set_angular_acceleration(math::v3 acceleration) const {
+		angular_accelerations.set(get_entry(_id), acceleration);
+	}
+}
\ No newline at end of file
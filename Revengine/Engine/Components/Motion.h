@@ -0,0 +1,40 @@
+#pragma once
+#include "ComponentsCommon.h"
+
+namespace revengine::motion {
+	// Grievances that move on their own get a motion component, which holds their linear and angular velocity and
+	// acceleration. Every component of every stream is its own array, and only moving grievances have entries in
+	// them, so static grievances cost nothing during integration.
+	struct init_info {
+		f32 linear_velocity[3]{}; // Units per second
+		f32 linear_acceleration[3]{};
+		f32 angular_velocity[3]{}; // Rotation axis scaled by radians per second, in world space
+		f32 angular_acceleration[3]{};
+	};
+
+	motivator create(const init_info& info, grievance::grievance grievance);
+	void remove(motivator m);
+
+	/// <summary>
+	/// Get the amount of moving grievances, which is the range that integrate() works on
+	/// </summary>
+	u32 count();
+
+	/// <summary>
+	/// Integrate the motion of a range of moving grievances with semi-implicit Euler, and write their new positions and
+	/// rotations into the transform arrays. Ranges that don't overlap can be integrated on different threads at the same
+	/// time, as long as nothing else touches transforms or motion components meanwhile
+	/// </summary>
+	/// <param name="dt">The time step, in seconds</param>
+	/// <param name="first">The first moving grievance to integrate</param>
+	/// <param name="count">The amount of moving grievances to integrate</param>
+	void integrate(f32 dt, u32 first, u32 count);
+
+	/// <summary>
+	/// Integrate every moving grievance on the calling thread
+	/// </summary>
+	void update(f32 dt);
+
+	void capture_state(snapshot::writer& w);
+	void restore_state(snapshot::reader& r);
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "PackedTransform.h"
+#include "Transform.h"
+#include "../Utilities/Quantization.h"
+#if defined(_WIN64)
+#include <DirectXPackedVector.h>
+#endif
+#include <cstring>
+
+namespace revengine::transform {
+	// Anonymous namespace
+	namespace {
+		constexpr f32 max_offset{ 65535.f };
+		constexpr u32 cell_bits{ 21 }; // Bits of each cell coordinate in the key of a cell
+		constexpr s32 max_cell{ 1 << (cell_bits - 1) }; // Cells go from -max_cell to max_cell - 1 on each axis
+
+		u64 cell_key(const s32* cell) {
+			// Shift the coordinates to be positive, so that every cell in range gets its own key
+			return ((u64)(cell[0] + max_cell) << (2 * cell_bits)) | ((u64)(cell[1] + max_cell) << cell_bits) | (u64)(cell[2] + max_cell);
+		}
+
+		bool pack_cells(const math::v3* positions, u32 count, packed_transforms& packed) {
+			const f32 cell_size{ packed.config.cell_size };
+			std::unordered_map<u64, u16> cell_indices;
+			packed.offsets.resize(3 * (size_t)count);
+			packed.cells.resize(count);
+
+			for (u32 i{ 0 }; i < count; i++) {
+				const math::v3& p{ positions[i] };
+				const f32 coordinates[3]{ std::floor(p.x / cell_size), std::floor(p.y / cell_size), std::floor(p.z / cell_size) };
+
+				// Cells outside of the key's range would share keys, and positions that aren't finite have no cell at all
+				for (u32 axis{ 0 }; axis < 3; axis++) {
+					if (!(coordinates[axis] >= -(f32)max_cell && coordinates[axis] < (f32)max_cell)) return false;
+				}
+
+				const s32 cell[3]{ (s32)coordinates[0], (s32)coordinates[1], (s32)coordinates[2] };
+
+				// Add the cell the first time a transform is in it
+				const u64 key{ cell_key(cell) };
+				auto it{ cell_indices.find(key) };
+				if (it == cell_indices.end()) {
+					if (packed.cell_origins.size() > 0xffff) return false;
+					it = cell_indices.emplace(key, (u16)packed.cell_origins.size()).first;
+					packed.cell_origins.emplace_back((f32)cell[0] * cell_size, (f32)cell[1] * cell_size, (f32)cell[2] * cell_size);
+				}
+
+				packed.cells[i] = it->second;
+
+				// Store the offset from the corner of the cell in steps of cell_size / 65535
+				const math::v3& origin{ packed.cell_origins[it->second] };
+				const f32 offset[3]{ p.x - origin.x, p.y - origin.y, p.z - origin.z };
+				for (u32 axis{ 0 }; axis < 3; axis++) {
+					const f32 step{ std::round(offset[axis] / cell_size * max_offset) };
+					packed.offsets[3 * (size_t)i + axis] = (u16)std::min(std::max(step, 0.f), max_offset);
+				}
+			}
+
+			return true;
+		}
+	}
+
+	bool pack(const packed_config& config, const math::v3* positions, const math::v4* rotations, const math::v3* scales, u32 count, packed_transforms& packed) {
+		assert(config.rotation_bits >= 2 && config.rotation_bits <= utl::max_smallest_three_bits);
+		assert(!count || (positions && rotations && scales));
+
+		// Keep the memory of the arrays around, but drop the old content
+		packed.config = config;
+		packed.count = count;
+		packed.rotations.resize(count);
+		packed.scales.clear();
+		packed.half_scales.clear();
+		packed.positions.clear();
+		packed.offsets.clear();
+		packed.cells.clear();
+		packed.cell_origins.clear();
+
+		for (u32 i{ 0 }; i < count; i++) {
+			// Transforms are created with an all zero rotation by default, which is packed as no rotation at all
+			const math::v4& q{ rotations[i] };
+			const bool empty{ q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w < math::epsilon };
+			const math::v4 rotation{ empty ? math::v4{ 0.f, 0.f, 0.f, 1.f } : q };
+			packed.rotations[i] = utl::pack_smallest_three(&rotation.x, config.rotation_bits);
+		}
+
+		bool exact{ true };
+		switch (config.scale) {
+		case scale_mode::full:
+			packed.scales.resize(3 * (size_t)count);
+			if (count) memcpy(packed.scales.data(), scales, 3 * (size_t)count * sizeof(f32));
+			break;
+		case scale_mode::uniform:
+			packed.scales.resize(count);
+			for (u32 i{ 0 }; i < count; i++) {
+				const math::v3& s{ scales[i] };
+				const f32 tolerance{ math::epsilon * std::max(1.f, std::abs(s.x)) };
+				exact &= std::abs(s.y - s.x) <= tolerance && std::abs(s.z - s.x) <= tolerance;
+				packed.scales[i] = s.x;
+			}
+			break;
+		case scale_mode::half:
+			packed.half_scales.resize(3 * (size_t)count);
+			if (count) DirectX::PackedVector::XMConvertFloatToHalfStream(packed.half_scales.data(), sizeof(u16), &scales[0].x, sizeof(f32), 3 * (size_t)count);
+			break;
+		}
+
+		if (config.cell_size > 0.f) exact &= pack_cells(positions, count, packed);
+		else packed.positions.assign(positions, positions + count);
+
+		return exact;
+	}
+
+	void unpack(const packed_transforms& packed, u32 first, u32 count, math::v3* positions, math::v4* rotations, math::v3* scales) {
+		using namespace DirectX;
+		assert(first + count <= packed.count);
+		if (!count) return;
+
+		const u32 end{ first + count };
+		const u32 bits{ packed.config.rotation_bits };
+		const u32 mask{ (1u << bits) - 1 };
+		const u32 half_steps{ (1u << (bits - 1)) - 1 };
+		const f32 precision{ 0.70710678118f / (f32)half_steps };
+
+		// The stored components are steps from -half_steps, so each one is step * precision - half_steps * precision
+		const XMVECTOR step{ XMVectorReplicate(precision) };
+		const XMVECTOR bias{ XMVectorReplicate(-(f32)half_steps * precision) };
+		const XMVECTOR zero{ XMVectorZero() };
+		const XMVECTOR one{ XMVectorReplicate(1.f) };
+		const XMVECTOR index2{ XMVectorReplicate(2.f) };
+		const XMVECTOR index3{ XMVectorReplicate(3.f) };
+
+		const bool cells{ packed.config.cell_size > 0.f };
+		const XMVECTOR offset_step{ XMVectorReplicate(packed.config.cell_size / max_offset) };
+
+		for (u32 i{ first }; i < end; i += 4) {
+			const u32 lanes{ std::min(4u, end - i) };
+
+			// Split the packed values into their parts. The last group repeats the last transform to fill its lanes
+			XMFLOAT4A stored[3];
+			XMFLOAT4A largest;
+			for (u32 lane{ 0 }; lane < 4; lane++) {
+				const u32 value{ packed.rotations[i + std::min(lane, lanes - 1)] };
+				(&stored[0].x)[lane] = (f32)((value >> (2 * bits)) & mask);
+				(&stored[1].x)[lane] = (f32)((value >> bits) & mask);
+				(&stored[2].x)[lane] = (f32)(value & mask);
+				(&largest.x)[lane] = (f32)(value >> (3 * bits));
+			}
+
+			const XMVECTOR a{ XMVectorMultiplyAdd(XMLoadFloat4A(&stored[0]), step, bias) };
+			const XMVECTOR b{ XMVectorMultiplyAdd(XMLoadFloat4A(&stored[1]), step, bias) };
+			const XMVECTOR c{ XMVectorMultiplyAdd(XMLoadFloat4A(&stored[2]), step, bias) };
+
+			// Rebuild the largest component from the unit length
+			const XMVECTOR sum{ XMVectorMultiplyAdd(a, a, XMVectorMultiplyAdd(b, b, XMVectorMultiply(c, c))) };
+			const XMVECTOR d{ XMVectorSqrt(XMVectorMax(XMVectorSubtract(one, sum), zero)) };
+
+			// Put it in the place of the dropped component, the stored ones keep their order around it
+			const XMVECTOR l{ XMLoadFloat4A(&largest) };
+			const XMVECTOR is0{ XMVectorLess(l, one) };
+			const XMVECTOR up_to1{ XMVectorLess(l, index2) };
+			XMFLOAT4A q[4];
+			XMStoreFloat4A(&q[0], XMVectorSelect(a, d, is0));
+			XMStoreFloat4A(&q[1], XMVectorSelect(XMVectorSelect(b, d, XMVectorEqual(l, one)), a, is0));
+			XMStoreFloat4A(&q[2], XMVectorSelect(XMVectorSelect(c, d, XMVectorEqual(l, index2)), b, up_to1));
+			XMStoreFloat4A(&q[3], XMVectorSelect(c, d, XMVectorEqual(l, index3)));
+
+			for (u32 lane{ 0 }; lane < lanes; lane++) {
+				rotations[i - first + lane] = { (&q[0].x)[lane], (&q[1].x)[lane], (&q[2].x)[lane], (&q[3].x)[lane] };
+			}
+
+			if (!cells) continue;
+
+			// Positions are the cell origin plus the offset
+			XMFLOAT4A offset[3];
+			XMFLOAT4A origin[3];
+			for (u32 lane{ 0 }; lane < 4; lane++) {
+				const u32 t{ i + std::min(lane, lanes - 1) };
+				const math::v3& o{ packed.cell_origins[packed.cells[t]] };
+				(&offset[0].x)[lane] = (f32)packed.offsets[3 * (size_t)t];
+				(&offset[1].x)[lane] = (f32)packed.offsets[3 * (size_t)t + 1];
+				(&offset[2].x)[lane] = (f32)packed.offsets[3 * (size_t)t + 2];
+				(&origin[0].x)[lane] = o.x;
+				(&origin[1].x)[lane] = o.y;
+				(&origin[2].x)[lane] = o.z;
+			}
+
+			XMFLOAT4A p[3];
+			for (u32 axis{ 0 }; axis < 3; axis++) {
+				XMStoreFloat4A(&p[axis], XMVectorMultiplyAdd(XMLoadFloat4A(&offset[axis]), offset_step, XMLoadFloat4A(&origin[axis])));
+			}
+
+			for (u32 lane{ 0 }; lane < lanes; lane++) {
+				positions[i - first + lane] = { (&p[0].x)[lane], (&p[1].x)[lane], (&p[2].x)[lane] };
+			}
+		}
+
+		if (!cells) memcpy(positions, &packed.positions[first], count * sizeof(math::v3));
+
+		switch (packed.config.scale) {
+		case scale_mode::full:
+			memcpy(&scales[0].x, &packed.scales[3 * (size_t)first], 3 * (size_t)count * sizeof(f32));
+			break;
+		case scale_mode::uniform:
+			for (u32 i{ 0 }; i < count; i++) {
+				const f32 s{ packed.scales[first + i] };
+				scales[i] = { s, s, s };
+			}
+			break;
+		case scale_mode::half:
+			// DirectXMath converts halfs with F16C when it's available
+			DirectX::PackedVector::XMConvertHalfToFloatStream(&scales[0].x, sizeof(f32), &packed.half_scales[3 * (size_t)first], sizeof(u16), 3 * (size_t)count);
+			break;
+		}
+	}
+
+	u64 memory_size(const packed_transforms& packed) {
+		return packed.rotations.size() * sizeof(u32) +
+			packed.scales.size() * sizeof(f32) +
+			packed.half_scales.size() * sizeof(u16) +
+			packed.positions.size() * sizeof(math::v3) +
+			packed.offsets.size() * sizeof(u16) +
+			packed.cells.size() * sizeof(u16) +
+			packed.cell_origins.size() * sizeof(math::v3);
+	}
+}
\ No newline at end of file
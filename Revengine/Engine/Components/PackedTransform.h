@@ -0,0 +1,69 @@
+#pragma once
+#include "ComponentsCommon.h"
+
+namespace revengine::transform {
+	// Reduced-precision storage for transforms, for worlds that are too big to keep at full precision. A full
+	// transform takes 40 bytes, while the smallest packed one takes 16: a smallest-three rotation in 4 bytes, a
+	// uniform scale in 4, and a position in 8 as a cell plus an offset inside it. Each part is its own array,
+	// so that unpacking a range only reads the bytes it needs
+	enum class scale_mode : u8 {
+		full, // 3 floats, exact
+		uniform, // 1 float - for grievances that scale the same way on every axis
+		half, // 3 half-precision floats, about 3 significant digits
+	};
+
+	struct packed_config {
+		u32 rotation_bits{ 10 }; // Bits for each of the three stored quaternion components, up to 10
+		scale_mode scale{ scale_mode::uniform };
+		f32 cell_size{ 0.f }; // Positions are stored relative to cells of this size, or as full floats when it's 0
+	};
+
+	struct packed_transforms {
+		packed_config config{};
+		u32 count{ 0 };
+		utl::vector<u32> rotations; // utl::pack_smallest_three()
+		utl::vector<f32> scales; // One per transform for uniform scales, or three for full scales
+		utl::vector<u16> half_scales; // Three per transform
+		utl::vector<math::v3> positions; // Full precision positions, when there are no cells
+		utl::vector<u16> offsets; // Three per transform, the position inside the cell in steps of cell_size / 65535
+		utl::vector<u16> cells; // The cell of each transform
+		utl::vector<math::v3> cell_origins;
+	};
+
+	/// <summary>
+	/// Pack transforms into reduced-precision storage, replacing what it held before
+	/// </summary>
+	/// <param name="config">How to store each part</param>
+	/// <param name="count">The amount of transforms</param>
+	/// <param name="packed">The storage to fill</param>
+	/// <returns>False if a scale wasn't uniform in uniform mode (the x scale is stored), or if the positions didn't fit into
+	/// cells: more than 65536 cells, or a cell more than a million cells away from the origin on an axis. The packed positions
+	/// are incomplete then</returns>
+	bool pack(const packed_config& config, const math::v3* positions, const math::v4* rotations, const math::v3* scales, u32 count, packed_transforms& packed);
+
+	/// <summary>
+	/// Unpack a range of transforms to full precision, four at a time with SIMD
+	/// </summary>
+	/// <param name="packed">The storage to read from</param>
+	/// <param name="first">The first transform to unpack</param>
+	/// <param name="count">The amount of transforms to unpack</param>
+	void unpack(const packed_transforms& packed, u32 first, u32 count, math::v3* positions, math::v4* rotations, math::v3* scales);
+
+	/// <summary>
+	/// Get the amount of bytes that the packed transforms use
+	/// </summary>
+	u64 memory_size(const packed_transforms& packed);
+
+	/// <summary>
+	/// Pack the transform data of the world, including holes, and free the full precision arrays, so that the world
+	/// is kept in less memory while it isn't simulated. Until unpack_data() is called, transforms can't be created,
+	/// removed or read, and the systems that update transforms skip them
+	/// </summary>
+	/// <returns>False if pack() returned false. Nothing was packed then, and the world keeps its full precision arrays</returns>
+	bool pack_data(const packed_config& config, packed_transforms& packed);
+
+	/// <summary>
+	/// Rebuild the full precision arrays from the transform data that was packed by pack_data()
+	/// </summary>
+	void unpack_data(const packed_transforms& packed);
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "Prefab.h"
+
+namespace revengine::prefab {
+	prefab::prefab(const grievance::grievance_info& info) {
+		// Make sure all Grievances have a transform component
+		assert(info.transform);
+		if (info.transform) _transform = *info.transform;
+		if (info.script) _script = *info.script;
+		if (info.motion) _motion = *info.motion;
+		_has_motion = info.motion != nullptr;
+		if (info.renderable) _renderable = *info.renderable;
+		_has_renderable = info.renderable != nullptr;
+		if (info.lifetime) _lifetime = *info.lifetime;
+		_has_lifetime = info.lifetime != nullptr;
+
+		// Keep a copy of the keyframes, as the animation info only points to them
+		if (info.animation && info.animation->keyframe_count) {
+			_animation = *info.animation;
+			_keyframes.assign(info.animation->keyframes, info.animation->keyframes + info.animation->keyframe_count);
+		}
+	}
+
+	animation::init_info* prefab::animation_info(animation::init_info& info) const {
+		if (_keyframes.empty()) return nullptr;
+		info = _animation;
+		info.keyframes = _keyframes.data();
+		return &info;
+	}
+
+	void prefab::instantiate(u32 count, grievance::grievance_id* ids, const transform::batch_info& overrides) const {
+		assert(ids);
+
+		// grievance_info points to non-const components, so give it copies of the prefab's
+		transform::init_info transform_info{ _transform };
+		script::init_info script_info{ _script };
+		animation::init_info animation_info_copy{};
+		motion::init_info motion_info{ _motion };
+		renderable::init_info renderable_info{ _renderable };
+		lifetime::init_info lifetime_info{ _lifetime };
+		const grievance::grievance_info info{
+			&transform_info,
+			script_info.script_creator ? &script_info : nullptr,
+			animation_info(animation_info_copy),
+			_has_motion ? &motion_info : nullptr,
+			_has_renderable ? &renderable_info : nullptr,
+			_has_lifetime ? &lifetime_info : nullptr,
+		};
+
+		grievance::create_batch(info, overrides, count, ids);
+	}
+
+	grievance::grievance prefab::instantiate(const transform::init_info& transform) const {
+		transform::init_info transform_info{ transform };
+		script::init_info script_info{ _script };
+		animation::init_info animation_info_copy{};
+		motion::init_info motion_info{ _motion };
+		renderable::init_info renderable_info{ _renderable };
+		lifetime::init_info lifetime_info{ _lifetime };
+		const grievance::grievance_info info{
+			&transform_info,
+			script_info.script_creator ? &script_info : nullptr,
+			animation_info(animation_info_copy),
+			_has_motion ? &motion_info : nullptr,
+			_has_renderable ? &renderable_info : nullptr,
+			_has_lifetime ? &lifetime_info : nullptr,
+		};
+
+		return grievance::create(info);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include "Grievance.h"
+#include "Transform.h"
+#include "Script.h"
+#include "Animation.h"
+#include "Motion.h"
+#include "Renderable.h"
+#include "Lifetime.h"
+
+namespace revengine::prefab {
+	// A prefab keeps its own copy of the components of a grievance, so that the grievance_info it was made from
+	// doesn't have to stay around. Instantiating it creates all copies with one batched call per component, which
+	// is meant for spawning many identical grievances at once, like projectiles
+	class prefab {
+	public:
+		explicit prefab(const grievance::grievance_info& info);
+
+		/// <summary>
+		/// Create copies of the prefab
+		/// </summary>
+		/// <param name="count">The amount of copies to create</param>
+		/// <param name="ids">The array to write the IDs of the copies to</param>
+		/// <param name="overrides">The transform values that differ per copy</param>
+		void instantiate(u32 count, grievance::grievance_id* ids, const transform::batch_info& overrides = {}) const;
+
+		grievance::grievance instantiate(const transform::init_info& transform) const;
+
+	private:
+		transform::init_info _transform{};
+		script::init_info _script{};
+		animation::init_info _animation{};
+		utl::vector<animation::keyframe> _keyframes;
+		motion::init_info _motion{};
+		bool _has_motion{ false };
+		renderable::init_info _renderable{};
+		bool _has_renderable{ false };
+		lifetime::init_info _lifetime{};
+		bool _has_lifetime{ false };
+
+		animation::init_info* animation_info(animation::init_info& info) const;
+	};
+}
\ No newline at end of file
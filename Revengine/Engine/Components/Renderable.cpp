@@ -0,0 +1,124 @@
+#include "Renderable.h"
+#include "../Core/WorldSnapshot.h"
+
+namespace revengine::renderable {
+	// Anonymous namespace
+	namespace {
+		// Renderables are kept in dense arrays, and found through id_mapping (double-indexing)
+		utl::vector<id::id_type> owners; // The grievance index of each renderable
+		utl::vector<u64> keys;
+		utl::vector<u8> visible;
+		utl::vector<renderable_id> renderable_ids;
+
+		utl::vector<id::id_type> id_mapping;
+		utl::vector<id::generation_type> generations;
+		utl::deque<renderable_id> free_ids;
+
+		bool exists(renderable_id id) {
+			assert(id::is_valid(id));
+			const id::id_type index{ id::index(id) };
+			return index < generations.size() && generations[index] == id::generation(id) && id::is_valid(id_mapping[index]);
+		}
+
+		u32 get_entry(renderable_id id) {
+			assert(exists(id));
+			return (u32)id_mapping[id::index(id)];
+		}
+	}
+
+	motivator create(const init_info& info, grievance::grievance grievance) {
+		assert(grievance.is_valid());
+
+		renderable_id id{};
+		if (free_ids.size() > id::min_deleted_elements) {
+			// Get an id from the front and increase its generation
+			id = free_ids.front();
+			assert(!exists(id));
+			free_ids.pop_front();
+			id = renderable_id{ id::new_generation(id) };
+			++generations[id::index(id)];
+		}
+		else {
+			// Stop before the index runs into the generation bits
+			if (!id::can_add_slots(id_mapping.size())) {
+				assert(!"Out of renderable IDs");
+				return motivator{};
+			}
+
+			// Add another ID at the end of id_mapping and generations
+			id = renderable_id{ (id::id_type)id_mapping.size() };
+			id_mapping.emplace_back();
+			generations.push_back(0);
+		}
+
+		owners.push_back(id::index(grievance.get_id()));
+		keys.push_back(make_key(info.mesh, info.material));
+		visible.push_back(info.visible ? 1 : 0);
+		renderable_ids.push_back(id);
+
+		id_mapping[id::index(id)] = (id::id_type)owners.size() - 1;
+		return motivator{ id };
+	}
+
+	void remove(motivator m) {
+		assert(m.is_valid() && exists(m.get_id()));
+		const renderable_id id{ m.get_id() };
+		const u32 entry{ get_entry(id) };
+		const renderable_id last_id{ renderable_ids.back() };
+
+		// Swap the entry with the last one and remove it
+		utl::erase_unordered(owners, entry);
+		utl::erase_unordered(keys, entry);
+		utl::erase_unordered(visible, entry);
+		utl::erase_unordered(renderable_ids, entry);
+
+		// Point the mapping of the moved entry at its new place
+		id_mapping[id::index(last_id)] = entry;
+		id_mapping[id::index(id)] = id::invalid_id;
+
+		// Recycle the ID, unless the slot has used up all of its generations
+		if (id::can_recycle(id)) free_ids.push_back(id);
+	}
+
+	data_view get_data() {
+		return { owners.data(), keys.data(), visible.data(), (u32)owners.size() };
+	}
+
+	void capture_state(snapshot::writer& w) {
+		w.write(owners);
+		w.write(keys);
+		w.write(visible);
+		w.write(renderable_ids);
+		w.write(id_mapping);
+		w.write(generations);
+		w.write(free_ids);
+	}
+
+	void restore_state(snapshot::reader& r) {
+		r.read(owners);
+		r.read(keys);
+		r.read(visible);
+		r.read(renderable_ids);
+		r.read(id_mapping);
+		r.read(generations);
+		r.read(free_ids);
+	}
+
+	bool motivator::is_visible() const {
+		return visible[get_entry(_id)] != 0;
+	}
+
+	void motivator::set_visible(bool value) const {
+		visible[get_entry(_id)] = value ? 1 : 0;
+	}
+
+	void motivator::set_mesh(u32 mesh) const {
+		u64& key{ keys[get_entry(_id)] };
+		key = make_key(mesh, (u32)(key >> 32));
+	}
+
+	void motivator::set_material(u32 material) const {
+		u64& key{ keys[get_entry(_id)] };
+		key = make_key((u32)key, material);
+	}
+}
\ No newline at end of file
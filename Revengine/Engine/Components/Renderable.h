@@ -0,0 +1,37 @@
+#pragma once
+#include "ComponentsCommon.h"
+
+namespace revengine::renderable {
+	// Grievances that can be drawn get a renderable component, which holds the mesh and the material to draw them
+	// with. Both are plain IDs that only mean something to the renderer
+	struct init_info {
+		u32 mesh{ 0 };
+		u32 material{ 0 };
+		bool visible{ true };
+	};
+
+	motivator create(const init_info& info, grievance::grievance grievance);
+	void remove(motivator m);
+
+	/// <summary>
+	/// Build the sort key of a mesh and material. Draws are sorted by material first, as switching materials costs
+	/// the renderer more than switching meshes
+	/// </summary>
+	constexpr u64 make_key(u32 mesh, u32 material) {
+		return ((u64)material << 32) | mesh;
+	}
+
+	// Direct access to the dense renderable arrays, for the render extraction. The pointers stay valid until a
+	// renderable is created or removed
+	struct data_view {
+		const id::id_type* owners; // The grievance index of each renderable
+		const u64* keys; // make_key() of each renderable
+		const u8* visible;
+		u32 count;
+	};
+
+	data_view get_data();
+
+	void capture_state(snapshot::writer& w);
+	void restore_state(snapshot::reader& r);
+}
\ No newline at end of file
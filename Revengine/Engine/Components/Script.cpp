@@ -1,13 +1,22 @@
 #include "Script.h"
 #include "Grievance.h"
+#include "../Core/WorldSnapshot.h"
 
 namespace revengine::script {
 	// Anonymous namespace
 	namespace {
 		utl::vector<detail::script_ptr> grievance_scripts; // Use double-indexing
+		utl::vector<script_id> script_ids; // The ID of each script in grievance_scripts
+		utl::vector<detail::script_creator> creators; // The creator of each script in grievance_scripts, used for reloading
 		utl::vector<id::id_type> id_mapping;
 		utl::vector<id::generation_type> generations;
-		utl::vector<script_id> free_ids;
+		utl::deque<script_id> free_ids;
+
+		// Scratch arrays for capturing and restoring snapshots, kept around to avoid reallocating
+		utl::vector<grievance::grievance_id> snapshot_owners;
+		utl::vector<u32> snapshot_offsets;
+		utl::vector<script_id> snapshot_ids;
+		utl::vector<detail::script_creator> snapshot_creators;
 
 		using script_registry = std::unordered_map<size_t, detail::script_creator>;
 
@@ -36,13 +45,14 @@ namespace revengine::script {
 
 			// Get the index part of the ID
 			const id::id_type index{ id::index(id) };
-			assert(index < generations.size() && id_mapping[index] < grievance_scripts.size());
+			assert(index < generations.size() && (!id::is_valid(id_mapping[index]) || id_mapping[index] < grievance_scripts.size()));
 
 			// Confirm that the generations agree
 			assert(generations[index] == id::generation(id));
 
 			// Return true if the generations agree and if the script slot has a pointer that is not null
 			return(generations[index] == id::generation(id)) &&
+				id::is_valid(id_mapping[index]) &&
 				grievance_scripts[id_mapping[index]] &&
 				grievance_scripts[id_mapping[index]]->is_valid();
 		}
@@ -61,8 +71,9 @@ namespace revengine::script {
 			// Look up the script by its tag
 			auto script = revengine::script::registry().find(tag);
 
-			// Confirm that we find it
-			assert(script != revengine::script::registry().end() && script->first == tag);
+			// The script might not exist anymore, such as when asked for by a reload after it was deleted
+			if (script == revengine::script::registry().end()) return nullptr;
+			assert(script->first == tag);
 
 			// Return the function
 			return script->second;
@@ -87,7 +98,7 @@ namespace revengine::script {
 			assert(!exists(id));
 
 			// Remove it from the free ids
-			free_ids.pop_back();
+			free_ids.pop_front();
 
 			// Increase the generation
 			id = script_id{ id::new_generation(id) };
@@ -96,6 +107,12 @@ namespace revengine::script {
 			++generations[id::index(id)];
 		}
 		else {
+			// Stop before the index runs into the generation bits
+			if (!id::can_add_slots(id_mapping.size())) {
+				assert(!"Out of script IDs");
+				return motivator{};
+			}
+
 			// Add another ID at the end of id_mapping and generations
 			id = script_id{ (id::id_type)id_mapping.size() };
 			id_mapping.emplace_back();
@@ -106,6 +123,8 @@ namespace revengine::script {
 
 		// Call script_creator to create a new instance of the script class
 		grievance_scripts.emplace_back(info.script_creator(grievance));
+		script_ids.emplace_back(id);
+		creators.emplace_back(info.script_creator);
 
 		// Confirm that the script ID is the same as the ID of the grievance
 		// it belongs to
@@ -119,8 +138,61 @@ namespace revengine::script {
 		return motivator{ id };
 	}
 
+	void create_batch(init_info info, const grievance::grievance_id* grievances, u32 count, motivator* motivators) {
+		assert(info.script_creator);
+		if (!count) return;
+
+		// Take recycled IDs while there are enough of them, and add new slots for the rest in one go
+		u32 recycled{ 0 };
+		for (; recycled < count && free_ids.size() > id::min_deleted_elements; recycled++) {
+			script_id id{ free_ids.front() };
+			assert(!exists(id));
+			free_ids.pop_front();
+
+			id = script_id{ id::new_generation(id) };
+			++generations[id::index(id)];
+			motivators[recycled] = motivator{ id };
+		}
+
+		const id::id_type first_slot{ (id::id_type)id_mapping.size() };
+
+		// Stop before the indices run into the generation bits, and leave the scripts that don't fit uncreated
+		if (!id::can_add_slots(first_slot, count - recycled)) {
+			assert(!"Out of script IDs");
+			const u32 added{ first_slot < id::detail::index_mask ? (u32)(id::detail::index_mask - first_slot) : 0 };
+			for (u32 i{ recycled + added }; i < count; i++) motivators[i] = motivator{};
+			count = recycled + added;
+		}
+
+		id_mapping.resize(first_slot + count - recycled);
+		generations.resize(first_slot + count - recycled, 0);
+
+		for (u32 i{ recycled }; i < count; i++) {
+			motivators[i] = motivator{ script_id{ first_slot + i - recycled } };
+		}
+
+		// Grow the dense arrays once, then construct the instances
+		const id::id_type first{ (id::id_type)grievance_scripts.size() };
+		grievance_scripts.reserve(first + count);
+		script_ids.reserve(first + count);
+		creators.resize(first + count, info.script_creator);
+
+		for (u32 i{ 0 }; i < count; i++) {
+			const script_id id{ motivators[i].get_id() };
+			const grievance::grievance grievance{ grievances[i] };
+			assert(grievance.is_valid());
+
+			grievance_scripts.emplace_back(info.script_creator(grievance));
+			script_ids.emplace_back(id);
+			assert(grievance_scripts.back()->get_id() == grievance.get_id());
+
+			id_mapping[id::index(id)] = first + i;
+		}
+	}
+
 	void remove(motivator m) {
-		assert(m.is_valid() && exists(m.get_id()));
+		// The instance might be missing if its script didn't exist anymore after a reload, so only check the mapping
+		assert(m.is_valid() && id::is_valid(id_mapping[id::index(m.get_id())]));
 
 		// Get the script ID
 		const script_id id{ m.get_id() };
@@ -129,10 +201,12 @@ namespace revengine::script {
 		const id::id_type index{ id_mapping[id::index(id)] };
 
 		// Get the ID of the last script in the array
-		const script_id last_id{ grievance_scripts.back()->script().get_id() };
+		const script_id last_id{ script_ids.back() };
 
 		// Swap the to-be-deleted ID with the last one and remove it
 		utl::erase_unordered(grievance_scripts, index);
+		utl::erase_unordered(script_ids, index);
+		utl::erase_unordered(creators, index);
 
 		// Point the id_mapping slot to the new index of the swapped element
 		id_mapping[id::index(last_id)] = index;
@@ -140,6 +214,140 @@ namespace revengine::script {
 		// Case: If there's only one script, then overwrite the swapping with
 		// an invalid ID
 		id_mapping[id::index(id)] = id::invalid_id;
+
+		// Recycle the ID, unless the slot has used up all of its generations
+		if (id::can_recycle(id)) free_ids.push_back(id);
+	}
+
+	u32 hot_reload(module_swapper swap, creator_rebinder rebind, void* user_data) {
+		assert(swap && rebind);
+		const u32 count{ (u32)grievance_scripts.size() };
+
+		// Remember the grievance of every script and the bytes of its state
+		utl::vector<grievance::grievance_id> owners(count);
+		utl::vector<u32> offsets(count + 1);
+		utl::vector<u8> state;
+
+		for (u32 i{ 0 }; i < count; i++) {
+			const detail::script_ptr& script{ grievance_scripts[i] };
+			offsets[i] = (u32)state.size();
+			owners[i] = script ? script->get_id() : grievance::grievance_id{ id::invalid_id };
+			if (!script) continue;
+
+			// Ask the script how much space it needs, then let it write its state
+			const u32 size{ script->serialize(nullptr, 0) };
+			if (!size) continue;
+
+			state.resize(offsets[i] + size);
+			[[maybe_unused]] const u32 written{ script->serialize(&state[offsets[i]], size) };
+			assert(written == size);
+		}
+
+		offsets[count] = (u32)state.size();
+
+		// Destroy the instances while their code is still loaded
+		for (detail::script_ptr& script : grievance_scripts) script.reset();
+
+		// Swap the module, and only rebind creators if the new one was loaded
+		if (swap(user_data)) {
+			// Many scripts share a creator, so rebind each one only once
+			std::unordered_map<detail::script_creator, detail::script_creator> rebound;
+			for (detail::script_creator& creator : creators) {
+				if (!creator) continue;
+
+				auto it{ rebound.find(creator) };
+				if (it == rebound.end()) it = rebound.emplace(creator, rebind(creator, user_data)).first;
+				creator = it->second;
+			}
+		}
+
+		u32 recreated{ 0 };
+
+		// Recreate the instances in the same slots and give them back their state
+		for (u32 i{ 0 }; i < count; i++) {
+			if (!creators[i] || !id::is_valid(owners[i])) continue;
+
+			const grievance::grievance grievance{ owners[i] };
+			grievance_scripts[i] = creators[i](grievance);
+			assert(grievance_scripts[i] && grievance_scripts[i]->get_id() == grievance.get_id());
+
+			const u32 size{ offsets[i + 1] - offsets[i] };
+			if (size) grievance_scripts[i]->deserialize(&state[offsets[i]], size);
+			++recreated;
+		}
+
+		return recreated;
+	}
+
+	void capture_state(snapshot::writer& w) {
+		w.write(script_ids);
+		w.write(creators);
+		w.write(id_mapping);
+		w.write(generations);
+		w.write(free_ids);
+
+		const u32 count{ (u32)grievance_scripts.size() };
+		snapshot_owners.resize(count);
+		snapshot_offsets.resize(count + 1);
+
+		// Let every script write its state straight into the snapshot
+		utl::vector<u8>& state{ w.next_block() };
+		state.clear();
+
+		for (u32 i{ 0 }; i < count; i++) {
+			const detail::script_ptr& script{ grievance_scripts[i] };
+			snapshot_offsets[i] = (u32)state.size();
+			snapshot_owners[i] = script ? script->get_id() : grievance::grievance_id{ id::invalid_id };
+			if (!script) continue;
+
+			const u32 size{ script->serialize(nullptr, 0) };
+			if (!size) continue;
+
+			state.resize(snapshot_offsets[i] + size);
+			[[maybe_unused]] const u32 written{ script->serialize(&state[snapshot_offsets[i]], size) };
+			assert(written == size);
+		}
+
+		snapshot_offsets[count] = (u32)state.size();
+
+		// Writing more blocks may move the state block, so these come after it
+		w.write(snapshot_owners);
+		w.write(snapshot_offsets);
+	}
+
+	void restore_state(snapshot::reader& r) {
+		r.read(snapshot_ids);
+		r.read(snapshot_creators);
+		r.read(id_mapping);
+		r.read(generations);
+		r.read(free_ids);
+		const utl::vector<u8>& state{ r.next_block() };
+		r.read(snapshot_owners);
+		r.read(snapshot_offsets);
+
+		const u32 count{ (u32)snapshot_ids.size() };
+
+		// Keep the instances that are still the same script in the same slot, and destroy the rest
+		for (u32 i{ 0 }; i < grievance_scripts.size(); i++) {
+			const bool same{ i < count && script_ids[i] == snapshot_ids[i] && creators[i] == snapshot_creators[i] };
+			if (!same) grievance_scripts[i].reset();
+		}
+
+		grievance_scripts.resize(count);
+		script_ids.swap(snapshot_ids);
+		creators.swap(snapshot_creators);
+
+		// Recreate the missing instances and give every script its state back. Scripts without a serialize()
+		// hook keep their current state if they were kept, or start over if they were recreated
+		for (u32 i{ 0 }; i < count; i++) {
+			if (!grievance_scripts[i]) {
+				if (!creators[i] || !id::is_valid(snapshot_owners[i])) continue;
+				grievance_scripts[i] = creators[i](grievance::grievance{ snapshot_owners[i] });
+			}
+
+			const u32 size{ snapshot_offsets[i + 1] - snapshot_offsets[i] };
+			if (size) grievance_scripts[i]->deserialize(&state[snapshot_offsets[i]], size);
+		}
 	}
 }
 
@@ -7,5 +7,34 @@ namespace revengine::script {
 	};
 
 	motivator create(init_info info, grievance::grievance grievance);
+
+	/// <summary>
+	/// Create the same script for many grievances at once. The arrays grow once for the whole batch, and the
+	/// instances are constructed in one pass
+	/// </summary>
+	/// <param name="info">The script to create</param>
+	/// <param name="grievances">The grievances to create the scripts for</param>
+	/// <param name="count">The amount of grievances</param>
+	/// <param name="motivators">The array to write the new motivators to</param>
+	void create_batch(init_info info, const grievance::grievance_id* grievances, u32 count, motivator* motivators);
 	void remove(motivator m);
+
+	using module_swapper = bool(*)(void* user_data);
+	using creator_rebinder = detail::script_creator(*)(detail::script_creator old_creator, void* user_data);
+
+	/// <summary>
+	/// Reload the game code that script instances were created from. The state of every live script is serialized and
+	/// the instances are destroyed while the old code is still loaded. Then the module is swapped, each creator is rebound
+	/// to the new module, and the instances are recreated in the same slots, so script and grievance IDs stay valid
+	/// </summary>
+	/// <param name="swap">Loads the new module and unloads the old one. If it fails, it has to leave the old module loaded,
+	/// and the scripts are recreated from the old code</param>
+	/// <param name="rebind">Finds the creator in the new module that matches a creator from the old one, or returns nullptr
+	/// if the script doesn't exist anymore - those scripts stay without an instance</param>
+	/// <param name="user_data">A pointer that is passed back to swap and rebind</param>
+	/// <returns>The amount of script instances that were recreated</returns>
+	u32 hot_reload(module_swapper swap, creator_rebinder rebind, void* user_data);
+
+	void capture_state(snapshot::writer& w);
+	void restore_state(snapshot::reader& r);
 }
\ No newline at end of file
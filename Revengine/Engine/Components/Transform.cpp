@@ -1,57 +1,315 @@
 #include "Transform.h"
 #include "Grievance.h"
+#include "PackedTransform.h"
+#include "../Core/WorldSnapshot.h"
 
 namespace revengine::transform {
 	// Anonymous namespace
 	namespace {
+		// Transform data is kept in dense arrays, and grievances find their data through id_mapping (double-indexing).
+		// Removing a transform leaves a hole in the dense arrays until defragment() moves live data into it, which is
+		// why a transform's ID is the index of its grievance and not the index of its data
 		utl::vector<math::v3> positions;
 		utl::vector<math::v4> rotations;
 		utl::vector<math::v3> scales;
+		utl::vector<id::id_type> owners; // The grievance index of each data slot, or invalid_id for holes
+		utl::vector<id::id_type> id_mapping; // The data slot of each grievance index
+		utl::vector<id::id_type> holes;
+
+		// State of the incremental sort by grievance index - the next grievance to visit and the slot it goes into
+		id::id_type sort_grievance{ 0 };
+		id::id_type sort_slot{ 0 };
+		u32 sort_swaps{ 0 };
+		bool sorted{ true };
+
+		// While the world is packed, the full precision arrays are empty and only owners, id_mapping and holes are kept
+		bool packed_data{ false };
+
+		void move_data(id::id_type from, id::id_type to) {
+			assert(id::is_valid(owners[from]) && !id::is_valid(owners[to]));
+
+			// Copy the data over and point the owning grievance at its new slot
+			positions[to] = positions[from];
+			rotations[to] = rotations[from];
+			scales[to] = scales[from];
+			owners[to] = owners[from];
+			id_mapping[owners[to]] = to;
+			owners[from] = id::invalid_id;
+		}
+
+		void swap_data(id::id_type a, id::id_type b) {
+			std::swap(positions[a], positions[b]);
+			std::swap(rotations[a], rotations[b]);
+			std::swap(scales[a], scales[b]);
+			std::swap(owners[a], owners[b]);
+			id_mapping[owners[a]] = a;
+			id_mapping[owners[b]] = b;
+		}
+
+		void trim_holes() {
+			// Drop dead slots from the end of the arrays - the holes that pointed to them are discarded when popped
+			while (!owners.empty() && !id::is_valid(owners.back())) {
+				positions.pop_back();
+				rotations.pop_back();
+				scales.pop_back();
+				owners.pop_back();
+			}
+		}
 	}
 
 	motivator create (const init_info& info, grievance::grievance grievance) {
-		assert(grievance.is_valid());
+		assert(grievance.is_valid() && !packed_data);
 		const id::id_type grievance_index{ id::index(grievance.get_id()) };
 
-		// Check if the motivator we are trying to add is within the the length
-		// of the array
-		if (positions.size() > grievance_index) {
+		// Make room in id_mapping for the grievance
+		if (id_mapping.size() <= grievance_index) id_mapping.resize(grievance_index + 1, id::invalid_id);
+		assert(!id::is_valid(id_mapping[grievance_index]));
+
+		// Discard holes that were trimmed off the end of the arrays
+		while (!holes.empty() && holes.back() >= owners.size()) holes.pop_back();
+
+		id::id_type index;
+
+		// Check if there's a hole that we can fill
+		if (!holes.empty()) {
 			// Override that slot with new values
-			positions[grievance_index] = math::v3(info.position);
-			rotations[grievance_index] = math::v4(info.rotation);
-			scales[grievance_index] = math::v3(info.scale);
+			index = holes.back();
+			holes.pop_back();
+			assert(!id::is_valid(owners[index]));
+			positions[index] = math::v3(info.position);
+			rotations[index] = math::v4(info.rotation);
+			scales[index] = math::v3(info.scale);
+			owners[index] = grievance_index;
 		}
 		else {
-			// Confirm that the index is the maximum size of the positions
-			assert(positions.size() == grievance_index);
-
 			// Emplace the arrays and add the data at the back
+			index = (id::id_type)positions.size();
 			positions.emplace_back(info.position);
 			rotations.emplace_back(info.rotation);
 			scales.emplace_back(info.scale);
+			owners.emplace_back(grievance_index);
 		}
 
-		return motivator(transform_id{(id::id_type)positions.size() - 1});
+		id_mapping[grievance_index] = index;
+		sorted = false;
+
+		return motivator(transform_id{ grievance_index });
+	}
+
+	void create_batch(const init_info& info, const batch_info& batch, const grievance::grievance_id* grievances, u32 count, motivator* motivators) {
+		assert(!packed_data);
+		if (!count) return;
+
+		// Make room in id_mapping for the grievance with the highest index
+		id::id_type max_index{ 0 };
+		for (u32 i{ 0 }; i < count; i++) max_index = std::max(max_index, id::index(grievances[i]));
+		if (id_mapping.size() <= max_index) id_mapping.resize(max_index + 1, id::invalid_id);
+
+		const math::v3 position{ info.position };
+		const math::v4 rotation{ info.rotation };
+		const math::v3 scale{ info.scale };
+
+		// Fill the holes one at a time. A partial defragment() can leave holes that were trimmed off the end of the
+		// arrays under ones that are still in range, so skip those on the way
+		u32 filled{ 0 };
+		while (filled < count && !holes.empty()) {
+			const id::id_type index{ holes.back() };
+			holes.pop_back();
+			if (index >= owners.size()) continue;
+			assert(!id::is_valid(owners[index]));
+
+			positions[index] = batch.positions ? batch.positions[filled] : position;
+			rotations[index] = batch.rotations ? batch.rotations[filled] : rotation;
+			scales[index] = batch.scales ? batch.scales[filled] : scale;
+			owners[index] = id::index(grievances[filled]);
+
+			assert(!id::is_valid(id_mapping[owners[index]]));
+			id_mapping[owners[index]] = index;
+			++filled;
+		}
+
+		// Add the rest to the end of the arrays, copying each array in one go
+		const id::id_type first{ (id::id_type)positions.size() };
+		const u32 added{ count - filled };
+
+		if (added) {
+			if (batch.positions) positions.insert(positions.end(), batch.positions + filled, batch.positions + count);
+			else positions.resize(first + added, position);
+			if (batch.rotations) rotations.insert(rotations.end(), batch.rotations + filled, batch.rotations + count);
+			else rotations.resize(first + added, rotation);
+			if (batch.scales) scales.insert(scales.end(), batch.scales + filled, batch.scales + count);
+			else scales.resize(first + added, scale);
+			owners.resize(first + added);
+		}
+
+		for (u32 i{ filled }; i < count; i++) {
+			const id::id_type index{ first + i - filled };
+			owners[index] = id::index(grievances[i]);
+
+			assert(!id::is_valid(id_mapping[owners[index]]));
+			id_mapping[owners[index]] = index;
+		}
+
+		for (u32 i{ 0 }; i < count; i++) motivators[i] = motivator{ transform_id{ id::index(grievances[i]) } };
+		sorted = false;
 	}
 
 	void remove(motivator m) {
 		// Confirm that the motivator is valid
-		assert(m.is_valid());
+		assert(m.is_valid() && !packed_data);
+
+		// Get the data slot of the transform
+		const id::id_type grievance_index{ id::index(m.get_id()) };
+		const id::id_type index{ id_mapping[grievance_index] };
+		assert(id::is_valid(index) && owners[index] == grievance_index);
+
+		// Mark the slot as a hole, to be filled by the next transform or by defragment()
+		owners[index] = id::invalid_id;
+		id_mapping[grievance_index] = id::invalid_id;
+		holes.push_back(index);
+		sorted = false;
+	}
+
+	u32 defragment(u32 max_steps, bool sort) {
+		assert(!packed_data);
+		u32 steps{ 0 };
+
+		// Fill holes with the live data from the end of the arrays
+		while (steps < max_steps && !holes.empty()) {
+			trim_holes();
+
+			const id::id_type hole{ holes.back() };
+			holes.pop_back();
+			++steps;
+
+			// Skip holes that were trimmed off the end
+			if (hole >= owners.size()) continue;
+
+			move_data((id::id_type)owners.size() - 1, hole);
+			trim_holes();
+		}
+
+		if (!holes.empty() || !sort || sorted) return steps;
+
+		// Order the data by grievance index, so that walking the grievances walks the data in order. Grievances are
+		// visited in index order and each live one is swapped into the next slot. Creating and removing transforms
+		// while this is in progress only makes the order less perfect until the next pass
+		while (steps < max_steps) {
+			// Start a new pass when all grievances were visited. If nothing had to be moved, the data is in order
+			// and stays that way until a transform is created or removed
+			if (sort_grievance >= id_mapping.size() || sort_slot >= owners.size()) {
+				sorted = !sort_swaps;
+				sort_grievance = 0;
+				sort_slot = 0;
+				sort_swaps = 0;
+				break;
+			}
+
+			const id::id_type current{ id_mapping[sort_grievance] };
+			if (id::is_valid(current)) {
+				if (current != sort_slot) {
+					swap_data(sort_slot, current);
+					++sort_swaps;
+				}
+
+				++sort_slot;
+			}
+
+			++sort_grievance;
+			++steps;
+		}
+
+		return steps;
+	}
+
+	data_view get_data() {
+		// Callers check is_packed() first, and get nothing to read from if they don't
+		assert(!packed_data);
+		if (packed_data) return {};
+		return { positions.data(), rotations.data(), scales.data(), id_mapping.data(), (u32)id_mapping.size(), (u32)positions.size() };
+	}
+
+	bool is_packed() {
+		return packed_data;
+	}
+
+	u64 memory_used() {
+		return positions.capacity() * sizeof(math::v3) +
+			rotations.capacity() * sizeof(math::v4) +
+			scales.capacity() * sizeof(math::v3) +
+			owners.capacity() * sizeof(id::id_type) +
+			id_mapping.capacity() * sizeof(id::id_type) +
+			holes.capacity() * sizeof(id::id_type);
+	}
+
+	bool pack_data(const packed_config& config, packed_transforms& packed) {
+		assert(!packed_data);
+
+		// The full precision arrays are all there is, so they stay unless everything was packed
+		if (!pack(config, positions.data(), rotations.data(), scales.data(), (u32)positions.size(), packed)) {
+			packed = {};
+			return false;
+		}
+
+		// Swap with empty arrays, as clearing keeps the memory
+		utl::vector<math::v3>{}.swap(positions);
+		utl::vector<math::v4>{}.swap(rotations);
+		utl::vector<math::v3>{}.swap(scales);
+		packed_data = true;
+		return true;
+	}
+
+	void unpack_data(const packed_transforms& packed) {
+		assert(packed_data && packed.count == owners.size());
+		positions.resize(packed.count);
+		rotations.resize(packed.count);
+		scales.resize(packed.count);
+		if (packed.count) unpack(packed, 0, packed.count, positions.data(), rotations.data(), scales.data());
+		packed_data = false;
+	}
+
+	void capture_state(snapshot::writer& w) {
+		// A packed world has no transform data to capture
+		assert(!packed_data);
+		w.write(positions);
+		w.write(rotations);
+		w.write(scales);
+		w.write(owners);
+		w.write(id_mapping);
+		w.write(holes);
+		w.write_value(sort_grievance);
+		w.write_value(sort_slot);
+		w.write_value(sort_swaps);
+		w.write_value(sorted);
+	}
+
+	void restore_state(snapshot::reader& r) {
+		r.read(positions);
+		r.read(rotations);
+		r.read(scales);
+		r.read(owners);
+		r.read(id_mapping);
+		r.read(holes);
+		r.read_value(sort_grievance);
+		r.read_value(sort_slot);
+		r.read_value(sort_swaps);
+		r.read_value(sorted);
+		packed_data = false;
 	}
 
 	// Initialize positions, rotations, and scales according to the index
 	math::v3 motivator::position() const {
-		assert(is_valid());
-		return positions[id::index(_id)];
+		assert(is_valid() && !packed_data);
+		return positions[id_mapping[id::index(_id)]];
 	}
 
 	math::v4 motivator::rotation() const {
-		assert(is_valid());
-		return rotations[id::index(_id)];
+		assert(is_valid() && !packed_data);
+		return rotations[id_mapping[id::index(_id)]];
 	}
 
 	math::v3 motivator::scale() const {
-		assert(is_valid());
-		return scales[id::index(_id)];
+		assert(is_valid() && !packed_data);
+		return scales[id_mapping[id::index(_id)]];
 	}
 }
\ No newline at end of file
@@ -8,6 +8,62 @@ namespace revengine::transform {
 		f32 scale[3]{ 1.f, 1.f, 1.f }; // Scale with default values of 1
 	};
 
+	// Per-transform values for create_batch(). Each array is either null, to give every transform the value from
+	// init_info, or has one entry per transform
+	struct batch_info {
+		const math::v3* positions{ nullptr };
+		const math::v4* rotations{ nullptr };
+		const math::v3* scales{ nullptr };
+	};
+
 	motivator create(const init_info& info, grievance::grievance grievance);
+
+	/// <summary>
+	/// Create transforms for many grievances at once. Holes are filled first, and the rest of the transforms are
+	/// added to the end of each array with one bulk copy
+	/// </summary>
+	/// <param name="info">The values shared by all transforms</param>
+	/// <param name="batch">The values that differ per transform</param>
+	/// <param name="grievances">The grievances to create the transforms for</param>
+	/// <param name="count">The amount of grievances</param>
+	/// <param name="motivators">The array to write the new motivators to</param>
+	void create_batch(const init_info& info, const batch_info& batch, const grievance::grievance_id* grievances, u32 count, motivator* motivators);
 	void remove(motivator m);
+
+	/// <summary>
+	/// Incrementally move live transform data into the holes left by removed transforms, and optionally
+	/// order it by grievance index. Transform and grievance IDs stay valid while data is moved, so this
+	/// can be called every frame with a small budget
+	/// </summary>
+	/// <param name="max_steps">The maximum amount of transforms to visit in this call</param>
+	/// <param name="sort">Whether to order the data by grievance index once there are no holes left</param>
+	/// <returns>The amount of steps that were taken - 0 when there is nothing left to do</returns>
+	u32 defragment(u32 max_steps, bool sort = true);
+
+	// Direct access to the dense transform arrays, for systems that update many transforms in one pass. The pointers
+	// stay valid until a transform is created or removed, or the data is defragmented
+	struct data_view {
+		math::v3* positions;
+		math::v4* rotations;
+		math::v3* scales;
+		const id::id_type* slots; // The data slot of each grievance index, or invalid_id
+		u32 slot_count;
+		u32 count; // The amount of data slots, including holes
+	};
+
+	data_view get_data();
+
+	/// <summary>
+	/// Check if the transform data was packed by pack_data(). There are no arrays to get while it is, so the systems
+	/// that read or write transforms skip their work
+	/// </summary>
+	bool is_packed();
+
+	/// <summary>
+	/// Get the amount of bytes that the transform arrays hold on to, including unused capacity
+	/// </summary>
+	u64 memory_used();
+
+	void capture_state(snapshot::writer& w);
+	void restore_state(snapshot::reader& r);
 }
\ No newline at end of file
@@ -0,0 +1,335 @@
+#include "ChangeJournal.h"
+#include "../Components/Grievance.h"
+#include "../Components/Transform.h"
+#include <cstring>
+
+namespace revengine::journal {
+	// Anonymous namespace
+	namespace {
+		platform::shared_memory memory{};
+		ring_header* header{ nullptr };
+		u8* ring{ nullptr };
+		u64 frame{ 0 };
+		bool synced{ false }; // Whether the last record() sent everything that had changed
+
+		// What the reader was last sent for each grievance index
+		utl::vector<transform_data> sent_transforms;
+		utl::vector<u8> sent_alive;
+		utl::vector<id::generation_type> sent_generations;
+		grievance::data_view grievances{}; // The grievance generations while record() runs
+
+		// The message that is being put together
+		utl::vector<u8> message;
+		u32 max_message_size{ 0 };
+		u32 open_range{ u32_invalid_id }; // The offset of the range that can still be extended, if any
+
+		void copy_to_ring(u64 position, const u8* data, u64 size) {
+			const u64 capacity{ header->capacity };
+			const u64 offset{ position & (capacity - 1) };
+			const u64 first{ std::min(size, capacity - offset) };
+			memcpy(ring + offset, data, first);
+			memcpy(ring, data + first, size - first);
+		}
+
+		void copy_from_ring(const ring_header* from, const u8* data, u64 position, u8* to, u64 size) {
+			const u64 capacity{ from->capacity };
+			const u64 offset{ position & (capacity - 1) };
+			const u64 first{ std::min(size, capacity - offset) };
+			memcpy(to, data + offset, first);
+			memcpy(to + first, data, size - first);
+		}
+
+		void begin_message() {
+			message.resize(sizeof(message_header));
+			*(message_header*)message.data() = {};
+			open_range = u32_invalid_id;
+		}
+
+		bool push_message() {
+			message_header& m{ *(message_header*)message.data() };
+			if (!m.range_count) return true;
+			m.size = (u32)message.size();
+			m.frame = frame;
+
+			// Only this thread moves the write position, and the reader only moves the read position
+			const u64 write{ header->write_position.load(std::memory_order_relaxed) };
+			const u64 read{ header->read_position.load(std::memory_order_acquire) };
+			if (header->capacity - (write - read) < m.size) return false;
+
+			copy_to_ring(write, message.data(), m.size);
+			header->write_position.store(write + m.size, std::memory_order_release);
+			return true;
+		}
+
+		u32 commit_message() {
+			// Remember what the reader has now
+			const message_header& m{ *(const message_header*)message.data() };
+			const u8* at{ message.data() + sizeof(message_header) };
+			u32 sent{ 0 };
+
+			for (u32 r{ 0 }; r < m.range_count; r++) {
+				const range_header& range{ *(const range_header*)at };
+				at += sizeof(range_header);
+
+				if (range.kind == change::transform) {
+					assert(range.first + range.count <= grievances.count);
+					memcpy(&sent_transforms[range.first], at, range.count * sizeof(transform_data));
+					memset(&sent_alive[range.first], 1, range.count);
+					memcpy(&sent_generations[range.first], &grievances.generations[range.first], range.count * sizeof(id::generation_type));
+					at += range.count * sizeof(transform_data);
+				}
+				else {
+					memset(&sent_alive[range.first], 0, range.count);
+				}
+
+				sent += range.count;
+			}
+
+			return sent;
+		}
+
+		void add_range(change kind, u32 index) {
+			const u32 offset{ (u32)message.size() };
+			message.resize(offset + sizeof(range_header));
+
+			range_header& range{ *(range_header*)&message[offset] };
+			range = { kind, index, 0, 0 };
+			++((message_header*)message.data())->range_count;
+			open_range = offset;
+		}
+
+		// Add one grievance to the message, and send the message first if it's full
+		// Returns false if the ring is full, and the grievance has to wait for the next frame
+		bool add_change(change kind, u32 index, const transform_data& current, u32& sent) {
+			const u32 size{ (u32)(kind == change::transform ? sizeof(transform_data) : 0) };
+			bool extend{ false };
+			if (open_range != u32_invalid_id) {
+				const range_header& range{ *(const range_header*)&message[open_range] };
+				extend = range.kind == kind && range.first + range.count == index;
+			}
+
+			const u32 needed{ size + (extend ? 0 : (u32)sizeof(range_header)) };
+			if (message.size() + needed > max_message_size) {
+				if (!push_message()) return false;
+
+				sent += commit_message();
+				begin_message();
+				extend = false;
+			}
+
+			if (!extend) add_range(kind, index);
+
+			++((range_header*)&message[open_range])->count;
+			if (size) {
+				const u32 offset{ (u32)message.size() };
+				message.resize(offset + size);
+				memcpy(&message[offset], &current, size);
+			}
+
+			return true;
+		}
+
+		// Check that a message copied out of the ring stays within its size, before any of it is handed out.
+		// The writer lives in another process, so this can't rely on asserts
+		bool is_valid_message(const u8* data, u32 size) {
+			const message_header& m{ *(const message_header*)data };
+			u64 at{ sizeof(message_header) };
+
+			for (u32 r{ 0 }; r < m.range_count; r++) {
+				if (size - at < sizeof(range_header)) return false;
+				const range_header& range{ *(const range_header*)(data + at) };
+				at += sizeof(range_header);
+
+				if (range.kind == change::transform) {
+					if ((u64)range.count * sizeof(transform_data) > size - at) return false;
+					at += (u64)range.count * sizeof(transform_data);
+				}
+				else if (range.kind != change::removed) {
+					return false;
+				}
+			}
+
+			return at == size;
+		}
+	}
+
+	bool initialize(const char* name, u32 capacity) {
+		assert(!header && capacity);
+
+		// Round up to a power of 2, so that offsets into the ring are a mask away
+		u64 size{ 1 };
+		while (size < capacity) size <<= 1;
+
+		if (!platform::create_shared_memory(name, sizeof(ring_header) + size, memory)) return false;
+
+		header = new(memory.data) ring_header{};
+		header->version = journal_version;
+		header->capacity = size;
+		header->magic.store(journal_magic, std::memory_order_release);
+		ring = memory.data + sizeof(ring_header);
+
+		// Keep messages small enough that the reader can work on one while the next is written
+		max_message_size = (u32)std::max(size / 4, (u64)sizeof(message_header) + sizeof(range_header) + sizeof(transform_data));
+		frame = 0;
+		synced = false;
+		sent_transforms.clear();
+		sent_alive.clear();
+		sent_generations.clear();
+		return true;
+	}
+
+	u32 record() {
+		// A packed world has no transforms to compare, and nothing changes until it's unpacked
+		if (!header || transform::is_packed()) return 0;
+
+		const transform::data_view data{ transform::get_data() };
+		grievances = grievance::get_data();
+
+		// Grievance indices that were never sent count as not alive
+		if (sent_alive.size() < data.slot_count) {
+			sent_transforms.resize(data.slot_count);
+			sent_alive.resize(data.slot_count, 0);
+			sent_generations.resize(data.slot_count, 0);
+		}
+
+		const u32 count{ (u32)sent_alive.size() };
+		u32 sent{ 0 };
+		bool full{ false };
+		begin_message();
+
+		for (u32 i{ 0 }; i < count; i++) {
+			const id::id_type slot{ i < data.slot_count ? data.slots[i] : id::invalid_id };
+
+			if (id::is_valid(slot)) {
+				assert(i < grievances.count);
+				const transform_data current{ data.positions[slot], data.rotations[slot], data.scales[slot] };
+				const bool same_grievance{ sent_alive[i] && sent_generations[i] == grievances.generations[i] };
+				if (same_grievance && !memcmp(&current, &sent_transforms[i], sizeof(transform_data))) {
+					open_range = u32_invalid_id;
+					continue;
+				}
+
+				// A new grievance took the index of one the reader still has, so the reader is told that the old one is
+				// gone first, even when both happened within one frame
+				if (sent_alive[i] && !same_grievance && !add_change(change::removed, i, current, sent)) {
+					full = true;
+					break;
+				}
+
+				// If the ring is full, the rest waits for the next frame
+				if (!add_change(change::transform, i, current, sent)) {
+					full = true;
+					break;
+				}
+			}
+			else {
+				if (!sent_alive[i]) {
+					open_range = u32_invalid_id;
+					continue;
+				}
+
+				if (!add_change(change::removed, i, {}, sent)) {
+					full = true;
+					break;
+				}
+			}
+		}
+
+		if (!full && push_message()) sent += commit_message();
+		else full = true;
+
+		synced = !full;
+		++frame;
+		return sent;
+	}
+
+	bool is_synced() {
+		return synced;
+	}
+
+	void shutdown() {
+		if (!header) return;
+
+		platform::close_shared_memory(memory);
+		header = nullptr;
+		ring = nullptr;
+		sent_transforms.clear();
+		sent_alive.clear();
+		sent_generations.clear();
+		message.clear();
+	}
+
+	bool reader::open(const char* name) {
+		close();
+
+		// Map the header first to find out how big the ring is
+		if (!platform::open_shared_memory(name, sizeof(ring_header), _memory)) return false;
+
+		const ring_header* const header{ (const ring_header*)_memory.data };
+		const bool ready{ header->magic.load(std::memory_order_acquire) == journal_magic && header->version == journal_version };
+		const u64 capacity{ header->capacity };
+		platform::close_shared_memory(_memory);
+
+		// The ring offsets are masked, so anything but a power of 2 would read outside of it
+		if (!capacity || (capacity & (capacity - 1))) return false;
+		if (!ready || !platform::open_shared_memory(name, sizeof(ring_header) + capacity, _memory)) return false;
+
+		_header = (ring_header*)_memory.data;
+		_ring = _memory.data + sizeof(ring_header);
+		return true;
+	}
+
+	void reader::close() {
+		if (_header) platform::close_shared_memory(_memory);
+		_header = nullptr;
+		_ring = nullptr;
+	}
+
+	u32 reader::read(range_callback callback, void* user_data) {
+		assert(callback);
+		if (!_header) return 0;
+
+		u64 read{ _header->read_position.load(std::memory_order_relaxed) };
+		const u64 write{ _header->write_position.load(std::memory_order_acquire) };
+		const u64 capacity{ _header->capacity };
+		u32 messages{ 0 };
+
+		// The positions can't be further apart than the ring is big, unless the writer doesn't agree with the layout
+		if (write < read || write - read > capacity) {
+			close();
+			return 0;
+		}
+
+		while (read < write) {
+			// Copy the message out, so that the writer can reuse its space while the ranges are handled
+			message_header m;
+			if (write - read < sizeof(message_header)) break;
+			copy_from_ring(_header, _ring, read, (u8*)&m, sizeof(message_header));
+			if (m.size < sizeof(message_header) || m.size > write - read) break;
+
+			_message.resize(m.size);
+			copy_from_ring(_header, _ring, read, _message.data(), m.size);
+			if (!is_valid_message(_message.data(), m.size)) break;
+
+			read += m.size;
+			_header->read_position.store(read, std::memory_order_release);
+
+			const u8* at{ _message.data() + sizeof(message_header) };
+			for (u32 r{ 0 }; r < m.range_count; r++) {
+				const range_header& range{ *(const range_header*)at };
+				at += sizeof(range_header);
+
+				const transform_data* const data{ range.kind == change::transform ? (const transform_data*)at : nullptr };
+				if (data) at += range.count * sizeof(transform_data);
+				callback(range, data, m.frame, user_data);
+			}
+
+			++messages;
+		}
+
+		// Every message up to the write position was read, unless one of them was broken. There's no telling where the
+		// next message would start after that, so the journal is closed
+		if (read < write) close();
+		return messages;
+	}
+}
\ No newline at end of file
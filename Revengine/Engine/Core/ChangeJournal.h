@@ -0,0 +1,108 @@
+#pragma once
+#include "../Common/CommonHeaders.h"
+#include "../Platform/SharedMemory.h"
+#include <atomic>
+
+namespace revengine::journal {
+	// The change journal sends the transforms that changed since the last frame to another process, like the editor,
+	// through a ring buffer in shared memory. There is one writer (the engine) and one reader, so the ring only needs
+	// the two positions below. Everything in this header describes the shared memory layout, and any reader has to
+	// agree with it byte for byte.
+	constexpr u32 journal_magic{ 0x4e4a5652 }; // "RVJN"
+	constexpr u32 journal_version{ 1 };
+
+	// Sits at the start of the shared memory, with the ring data right after it. The positions count every byte
+	// ever written and read, and only the lowest bits are used as offsets into the ring. Each position is on its
+	// own cache line so that the writer and the reader don't slow each other down
+	struct ring_header {
+		std::atomic<u32> magic; // Set last, once the rest of the header is ready
+		u32 version;
+		u64 capacity; // The size of the ring data, always a power of 2
+		alignas(64) std::atomic<u64> write_position;
+		alignas(64) std::atomic<u64> read_position;
+	};
+
+	static_assert(std::atomic<u64>::is_always_lock_free, "The ring positions are shared between processes, so they have to be lock-free");
+
+	enum class change : u32 {
+		transform, // The range is followed by one transform_data per grievance
+		removed, // The grievances of the range don't exist anymore
+	};
+
+	// A message is a message_header, followed by range_count ranges. Ranges are identified by grievance index.
+	// When a new grievance takes the index of one that was sent before, the index is sent as removed and then as
+	// changed, even if both happened within one frame, so that readers can drop what they kept for the old grievance.
+	// One frame may be split into several messages
+	struct message_header {
+		u32 size; // The size of the whole message, including this header
+		u32 range_count;
+		u64 frame;
+	};
+
+	struct range_header {
+		change kind;
+		u32 first; // The index of the first grievance
+		u32 count;
+		u32 reserved;
+	};
+
+	struct transform_data {
+		math::v3 position;
+		math::v4 rotation;
+		math::v3 scale;
+	};
+
+	/// <summary>
+	/// Create the shared memory for the journal. The next record() sends every grievance
+	/// </summary>
+	/// <param name="name">The name the reader opens the journal by</param>
+	/// <param name="capacity">The size of the ring in bytes, rounded up to a power of 2</param>
+	/// <returns>False if the shared memory couldn't be created</returns>
+	bool initialize(const char* name, u32 capacity);
+
+	/// <summary>
+	/// Compare every transform with what was sent before, and send the grievances that changed. Transforms are written
+	/// directly by several systems, so this compares against a copy instead of relying on every writer to mark
+	/// changes. If the reader falls behind and the ring fills up, the rest is sent by the next call. Called once per frame,
+	/// and sends nothing while the transforms are packed
+	/// </summary>
+	/// <returns>The amount of grievances that were sent</returns>
+	u32 record();
+
+	/// <summary>
+	/// Check if the last record() sent everything that had changed, or if some of it has to wait for the reader
+	/// </summary>
+	bool is_synced();
+	void shutdown();
+
+	// Reads the journal of another process - or of the same one, in tests
+	class reader {
+	public:
+		using range_callback = void(*)(const range_header& range, const transform_data* data, u64 frame, void* user_data);
+
+		~reader() { close(); }
+
+		/// <summary>
+		/// Open a journal that was created with initialize()
+		/// </summary>
+		/// <returns>False if there is no journal with the name, or if it has a different version</returns>
+		bool open(const char* name);
+		void close();
+		bool is_open() const { return _header != nullptr; }
+
+		/// <summary>
+		/// Read every message that arrived since the last call. Messages are checked against their size before any of
+		/// their ranges are handed out, and the journal is closed at the first one that doesn't fit, as nothing after it
+		/// can be trusted either
+		/// </summary>
+		/// <param name="callback">Called for each range, with the transforms for changed ranges and null for removed ones</param>
+		/// <returns>The amount of messages that were read</returns>
+		u32 read(range_callback callback, void* user_data);
+
+	private:
+		platform::shared_memory _memory{};
+		ring_header* _header{ nullptr };
+		const u8* _ring{ nullptr };
+		utl::vector<u8> _message;
+	};
+}
\ No newline at end of file
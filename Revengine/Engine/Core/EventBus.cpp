@@ -0,0 +1,219 @@
+#include "EventBus.h"
+#include "../EngineAPI/Log.h"
+#include "../Utilities/ThreadQueues.h"
+#include <atomic>
+#include <cstring>
+#include <numeric>
+
+namespace revengine::events {
+	// Anonymous namespace
+	namespace {
+		// Every record in a queue is a header followed by the event bytes
+		struct record_header {
+			detail::type_id type;
+			id::id_type target;
+		};
+
+		struct event_queues_tag {};
+		using event_queues = utl::thread_queues<event_queues_tag, 1024 * 1024>; // Bytes of events each thread can post per frame
+
+		struct subscriber {
+			subscription_id id;
+			detail::handler_invoker invoker;
+			detail::erased_handler handler;
+			void* user_data;
+			grievance::grievance_id target;
+		};
+
+		// All the events of one type that were delivered by the last dispatch
+		struct event_stream {
+			u32 event_size{ 0 };
+			bool sorted{ true };
+			utl::vector<u8> data;
+			utl::vector<grievance::grievance_id> targets;
+			utl::vector<subscriber> subscribers;
+
+			// Scratch buffers for sorting, kept around to avoid reallocating every frame
+			utl::vector<u32> order;
+			utl::vector<u8> sorted_data;
+			utl::vector<grievance::grievance_id> sorted_targets;
+		};
+
+		// Every thread that posts gets its own queue, which dispatch() drains
+		event_queues queues;
+
+		utl::vector<event_stream> streams;
+		u32 next_subscription{ 0 };
+		bool dispatching{ false };
+
+		event_stream& get_stream(detail::type_id type, u32 size) {
+			// Add streams for every type up to this one
+			if (type >= streams.size()) streams.resize(type + 1);
+
+			// Remember the size of the events, or confirm that it agrees with previous events of the type
+			event_stream& stream{ streams[type] };
+			assert(!stream.event_size || stream.event_size == size);
+			stream.event_size = size;
+			return stream;
+		}
+
+		void append_event(const u8* record, u32 size) {
+			record_header header;
+			memcpy(&header, record, sizeof(record_header));
+			const u32 event_size{ size - (u32)sizeof(record_header) };
+			event_stream& stream{ get_stream(header.type, event_size) };
+			const grievance::grievance_id target{ header.target };
+
+			// Keep track of whether the events are still ordered by target
+			if (!stream.targets.empty() && target < stream.targets.back()) stream.sorted = false;
+
+			// Append the event to the end of the contiguous array of its type
+			const size_t offset{ stream.data.size() };
+			stream.data.resize(offset + event_size);
+			memcpy(&stream.data[offset], record + sizeof(record_header), event_size);
+			stream.targets.push_back(target);
+		}
+
+		void sort_by_target(event_stream& stream) {
+			const u32 count{ (u32)stream.targets.size() };
+			const u32 size{ stream.event_size };
+
+			// Order the events by target, keeping the posting order for events with the same target
+			stream.order.resize(count);
+			std::iota(stream.order.begin(), stream.order.end(), 0u);
+			std::stable_sort(stream.order.begin(), stream.order.end(), [&stream](u32 a, u32 b) {
+				return stream.targets[a] < stream.targets[b];
+			});
+
+			// Gather the events in their new order and swap them in
+			stream.sorted_data.resize(stream.data.size());
+			stream.sorted_targets.resize(count);
+			for (u32 i{ 0 }; i < count; i++) {
+				memcpy(&stream.sorted_data[(size_t)i * size], &stream.data[(size_t)stream.order[i] * size], size);
+				stream.sorted_targets[i] = stream.targets[stream.order[i]];
+			}
+
+			stream.data.swap(stream.sorted_data);
+			stream.targets.swap(stream.sorted_targets);
+			stream.sorted = true;
+		}
+
+		detail::erased_view target_range(const event_stream& stream, grievance::grievance_id target) {
+			assert(stream.sorted);
+
+			// Events are sorted by target, so all events for one grievance are next to each other
+			const auto range{ std::equal_range(stream.targets.begin(), stream.targets.end(), target,
+				[](id::id_type a, id::id_type b) { return a < b; }) };
+			const u32 first{ (u32)(range.first - stream.targets.begin()) };
+			const u32 count{ (u32)(range.second - range.first) };
+			if (!count) return {};
+
+			return { &stream.data[(size_t)first * stream.event_size], &stream.targets[first], count };
+		}
+	}
+
+	namespace detail {
+		type_id next_type_id() {
+			static std::atomic<type_id> next{ 0 };
+			return next.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		bool post(type_id type, u32 size, const void* data, grievance::grievance_id target) {
+			assert(data && size);
+			u8* const record{ queues.begin_record(sizeof(record_header) + size) };
+
+			// Check if the consumer has freed enough space
+			if (!record) {
+				LOG_WARNING("Event queue is full, dropped an event of type {} with {} bytes", type, size);
+				assert(!"Event queue is full, dispatch() needs to be called more often or the capacity increased");
+				return false;
+			}
+
+			// Write the header and the event, and publish the record to the consumer
+			const record_header header{ type, (id::id_type)target };
+			memcpy(record, &header, sizeof(record_header));
+			memcpy(record + sizeof(record_header), data, size);
+			queues.end_record();
+			return true;
+		}
+
+		subscription_id subscribe(type_id type, u32 size, handler_invoker invoker, erased_handler handler,
+			void* user_data, grievance::grievance_id target) {
+			// Subscribers can't be added while they're being iterated
+			assert(!dispatching);
+
+			const subscription_id id{ next_subscription++ };
+			get_stream(type, size).subscribers.push_back({ id, invoker, handler, user_data, target });
+			return id;
+		}
+
+		erased_view view(type_id type) {
+			if (type >= streams.size() || streams[type].targets.empty()) return {};
+			const event_stream& stream{ streams[type] };
+			return { stream.data.data(), stream.targets.data(), (u32)stream.targets.size() };
+		}
+
+		erased_view view(type_id type, grievance::grievance_id target) {
+			if (type >= streams.size() || streams[type].targets.empty()) return {};
+			return target_range(streams[type], target);
+		}
+	}
+
+	void unsubscribe(subscription_id id) {
+		assert(id::is_valid(id) && !dispatching);
+
+		// Subscriptions change rarely, so a linear search is enough
+		for (event_stream& stream : streams) {
+			for (u32 i{ 0 }; i < stream.subscribers.size(); i++) {
+				if (stream.subscribers[i].id == id) {
+					stream.subscribers.erase(stream.subscribers.begin() + i);
+					return;
+				}
+			}
+		}
+	}
+
+	void dispatch() {
+		assert(!dispatching);
+		dispatching = true;
+
+		// The events from the last frame are released now
+		for (event_stream& stream : streams) {
+			stream.data.clear();
+			stream.targets.clear();
+			stream.sorted = true;
+		}
+
+		// Gather the events from every thread into the per-type arrays
+		queues.drain(append_event);
+
+		for (event_stream& stream : streams) {
+			if (stream.targets.empty()) continue;
+			if (!stream.sorted) sort_by_target(stream);
+
+			const u32 count{ (u32)stream.targets.size() };
+
+			// Deliver the whole array to broadcast subscribers, and only the matching range to targeted ones
+			for (const subscriber& s : stream.subscribers) {
+				if (!id::is_valid(s.target)) {
+					s.invoker(s.handler, stream.data.data(), stream.targets.data(), count, s.user_data);
+				}
+				else {
+					const detail::erased_view range{ target_range(stream, s.target) };
+					if (range.count) s.invoker(s.handler, range.events, range.targets, range.count, s.user_data);
+				}
+			}
+		}
+
+		dispatching = false;
+	}
+
+	void shutdown() {
+		assert(!dispatching);
+
+		// Make every thread register a new queue the next time it posts. This must only be called while no other
+		// thread is posting events
+		queues.reset();
+		streams.clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+#include "../EngineAPI/EventBus.h"
+
+namespace revengine::events {
+	void dispatch();
+	void shutdown();
+}
\ No newline at end of file
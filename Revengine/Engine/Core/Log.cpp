@@ -0,0 +1,261 @@
+#include "Log.h"
+#include "../Utilities/ThreadQueues.h"
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace revengine::log {
+	// Anonymous namespace
+	namespace {
+		// Every record in a queue is a header followed by the arguments
+		struct record_header {
+			u64 time;
+			detail::format_id format;
+		};
+
+		struct format_info {
+			level severity;
+			const char* format;
+			const char* file;
+			u32 line;
+		};
+
+		// A record that was taken out of a queue, waiting to be written in time order
+		struct pending_record {
+			u64 time;
+			u32 offset;
+			detail::format_id format;
+			u32 size;
+		};
+
+		constexpr std::chrono::milliseconds flush_interval{ 2 };
+
+		struct log_queues_tag {};
+		using log_queues = utl::thread_queues<log_queues_tag, 1024 * 1024>; // Bytes of records each thread can log before the writer catches up
+
+		// Every thread that logs gets its own queue, which the writer drains
+		log_queues queues;
+
+		std::atomic<bool> running{ false };
+		std::atomic<u8> min_level{ (u8)level::info };
+
+		// Formats are registered once per call site and are kept across shutdowns, as the call sites keep their IDs
+		std::mutex format_mutex;
+		utl::vector<format_info> formats;
+
+		// State of the writing thread. flush_mutex is held while records are taken out of the queues and written
+		std::mutex flush_mutex;
+		std::condition_variable flush_signal;
+		std::thread writer;
+		std::ofstream file;
+		u64 start_time{ 0 };
+		utl::vector<u8> pending_data;
+		utl::vector<pending_record> pending;
+		std::string text;
+
+		u64 now() {
+			return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		void append_pending(const u8* record, u32 size) {
+			record_header header;
+			memcpy(&header, record, sizeof(record_header));
+			const u32 args_size{ size - (u32)sizeof(record_header) };
+
+			const u32 offset{ (u32)pending_data.size() };
+			pending_data.insert(pending_data.end(), record + sizeof(record_header), record + size);
+			pending.push_back({ header.time, offset, header.format, args_size });
+		}
+
+		const char* level_name(level level) {
+			switch (level) {
+			case level::info: return "INFO";
+			case level::warning: return "WARNING";
+			case level::error: return "ERROR";
+			}
+
+			return "";
+		}
+
+		void append_arg(const u8*& data, const u8* const end) {
+			assert(data < end);
+			const detail::arg_type type{ (detail::arg_type)*data++ };
+
+			if (type == detail::arg_type::string) {
+				u32 length;
+				memcpy(&length, data, sizeof(u32));
+				data += sizeof(u32);
+				assert(data + length <= end);
+				text.append((const char*)data, length);
+				data += length;
+				return;
+			}
+
+			u64 bits;
+			memcpy(&bits, data, sizeof(u64));
+			data += sizeof(u64);
+
+			char buffer[32];
+			switch (type) {
+			case detail::arg_type::signed_int: *std::to_chars(buffer, buffer + sizeof(buffer) - 1, (s64)bits).ptr = 0; break;
+			case detail::arg_type::unsigned_int: *std::to_chars(buffer, buffer + sizeof(buffer) - 1, bits).ptr = 0; break;
+			case detail::arg_type::floating: {
+				double value;
+				memcpy(&value, &bits, sizeof(double));
+				snprintf(buffer, sizeof(buffer), "%g", value);
+			} break;
+			case detail::arg_type::boolean: snprintf(buffer, sizeof(buffer), "%s", bits ? "true" : "false"); break;
+			case detail::arg_type::pointer: snprintf(buffer, sizeof(buffer), "0x%016llx", (unsigned long long)bits); break;
+			default: assert(false); buffer[0] = 0; break;
+			}
+
+			text += buffer;
+		}
+
+		void append_record(const pending_record& record) {
+			const format_info& info{ formats[record.format] };
+			char prefix[64];
+			snprintf(prefix, sizeof(prefix), "[%.3fms] [%s] ", (double)(record.time - start_time) / 1e6, level_name(info.severity));
+			text += prefix;
+
+			// Replace the placeholders with the arguments, in order
+			const u8* data{ pending_data.data() + record.offset };
+			const u8* const end{ data + record.size };
+
+			for (const char* c{ info.format }; *c; c++) {
+				if (c[0] == '{' && c[1] == '}') {
+					if (data < end) append_arg(data, end);
+					else text += "{?}";
+					++c;
+				}
+				else {
+					text += *c;
+				}
+			}
+
+			char line[16];
+			*std::to_chars(line, line + sizeof(line) - 1, info.line).ptr = 0;
+			text += " (";
+			text += info.file;
+			text += ':';
+			text += line;
+			text += ")\n";
+		}
+
+		void write_records() {
+			std::lock_guard<std::mutex> lock{ flush_mutex };
+			if (!file.is_open()) return;
+
+			pending_data.clear();
+			pending.clear();
+
+			// Take the records out of every thread's queue
+			const u32 dropped{ queues.drain(append_pending) };
+
+			if (pending.empty() && !dropped) return;
+
+			// Each queue is in order, but the threads have to be interleaved by time
+			std::stable_sort(pending.begin(), pending.end(), [](const pending_record& a, const pending_record& b) {
+				return a.time < b.time;
+			});
+
+			text.clear();
+			{
+				std::lock_guard<std::mutex> format_lock{ format_mutex };
+				for (const pending_record& record : pending) append_record(record);
+			}
+
+			if (dropped) text += "[WARNING] " + std::to_string(dropped) + " log records were dropped because a queue was full\n";
+
+			file.write(text.data(), (std::streamsize)text.size());
+			file.flush();
+		}
+
+		void writer_loop() {
+			std::mutex wait_mutex;
+			std::unique_lock<std::mutex> lock{ wait_mutex };
+
+			while (running.load(std::memory_order_acquire)) {
+				write_records();
+				flush_signal.wait_for(lock, flush_interval);
+			}
+		}
+	}
+
+	namespace detail {
+		format_id register_format(level level, const char* format, const char* file, u32 line) {
+			assert(format && file);
+			std::lock_guard<std::mutex> lock{ format_mutex };
+			formats.push_back({ level, format, file, line });
+			return (format_id)formats.size() - 1;
+		}
+
+		bool is_enabled(level level) {
+			return running.load(std::memory_order_relaxed) && (u8)level >= min_level.load(std::memory_order_relaxed);
+		}
+
+		u8* begin_record(format_id format, u32 size) {
+			if (!running.load(std::memory_order_relaxed)) return nullptr;
+
+			// Drop the record if the writer hasn't freed enough space. Logging must never block the caller
+			u8* const record{ queues.begin_record(sizeof(record_header) + size) };
+			if (!record) return nullptr;
+
+			// Write the header, and let the caller write the arguments after it
+			const record_header header{ now(), format };
+			memcpy(record, &header, sizeof(record_header));
+			return record + sizeof(record_header);
+		}
+
+		void end_record() {
+			// Publish the record to the writer
+			queues.end_record();
+		}
+	}
+
+	bool initialize(const char* path) {
+		assert(!running.load() && path);
+
+		{
+			std::lock_guard<std::mutex> lock{ flush_mutex };
+			file.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+			if (!file.is_open()) return false;
+			start_time = now();
+		}
+
+		running.store(true, std::memory_order_release);
+		writer = std::thread{ writer_loop };
+		return true;
+	}
+
+	void flush() {
+		write_records();
+	}
+
+	void shutdown() {
+		if (!running.exchange(false, std::memory_order_acq_rel)) return;
+
+		// Stop the writing thread, then write what it left behind
+		flush_signal.notify_all();
+		writer.join();
+		write_records();
+
+		{
+			std::lock_guard<std::mutex> lock{ flush_mutex };
+			file.close();
+		}
+
+		// Make every thread register a new queue the next time it logs
+		queues.reset();
+	}
+
+	void set_min_level(level level) {
+		min_level.store((u8)level, std::memory_order_relaxed);
+	}
+}
\ No newline at end of file
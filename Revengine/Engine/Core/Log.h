@@ -0,0 +1,23 @@
+#pragma once
+#include "../EngineAPI/Log.h"
+
+namespace revengine::log {
+	/// <summary>
+	/// Open the log file and start the thread that writes to it. Records logged before this are dropped
+	/// </summary>
+	/// <param name="path">The file to write to - it is overwritten</param>
+	/// <returns>False if the file couldn't be opened</returns>
+	bool initialize(const char* path);
+
+	/// <summary>
+	/// Write every record that was logged before this call to the file
+	/// </summary>
+	void flush();
+
+	/// <summary>
+	/// Write the remaining records, stop the writing thread and close the file. No other thread may log while this runs
+	/// </summary>
+	void shutdown();
+
+	void set_min_level(level level);
+}
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "RenderExtraction.h"
+#include "../Components/Renderable.h"
+#include "../Components/Transform.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace revengine::extraction {
+	// Anonymous namespace
+	namespace {
+		// Renderables are handed out to threads in chunks of this many, so that fast threads take more of them
+		constexpr u32 chunk_size{ 4096 };
+		constexpr u32 radix_bits{ 8 };
+		constexpr u32 radix_size{ 1 << radix_bits };
+		constexpr u32 radix_passes{ 64 / radix_bits };
+
+		struct chunk_output {
+			u32 thread;
+			u32 offset;
+			u32 count;
+		};
+
+		// Entries point into the packets, so that the draws are only copied once, into the list
+		struct sort_entry {
+			u64 key;
+			const draw_item* item;
+		};
+
+		// The two draw lists
+		utl::vector<draw_item> lists[2];
+		bool in_use[2]{};
+		u64 frame{ 0 };
+		std::mutex list_mutex;
+		std::condition_variable list_released;
+
+		// Every thread gathers its draws into its own packets, the calling thread being number 0
+		utl::vector<utl::vector<draw_item>> packets;
+		utl::vector<chunk_output> chunk_outputs;
+		utl::vector<sort_entry> sort_entries[2];
+		u32 histograms[radix_passes][radix_size];
+
+		// The job that the workers are working on
+		renderable::data_view job_renderables{};
+		transform::data_view job_transforms{};
+		u32 chunk_count{ 0 };
+		std::atomic<u32> next_chunk{ 0 };
+		std::atomic<u32> busy_workers{ 0 };
+
+		std::mutex job_mutex;
+		std::condition_variable job_signal;
+		u64 job_generation{ 0 };
+		bool stopping{ false };
+		utl::vector<std::thread> workers;
+
+		void build_item(draw_item& item, u32 renderable) {
+			const id::id_type owner{ job_renderables.owners[renderable] };
+			const id::id_type slot{ job_transforms.slots[owner] };
+			assert(id::is_valid(slot));
+
+			const math::v3& p{ job_transforms.positions[slot] };
+			const math::v4& q{ job_transforms.rotations[slot] };
+			const math::v3& s{ job_transforms.scales[slot] };
+
+			item.key = job_renderables.keys[renderable];
+			item.grievance = owner;
+			item.reserved = 0;
+
+			// Rotation matrix of the quaternion, with each column scaled by the scale on its axis
+			const f32 xx{ q.x * q.x }, yy{ q.y * q.y }, zz{ q.z * q.z };
+			const f32 xy{ q.x * q.y }, xz{ q.x * q.z }, yz{ q.y * q.z };
+			const f32 wx{ q.w * q.x }, wy{ q.w * q.y }, wz{ q.w * q.z };
+
+			item.world[0][0] = (1.f - 2.f * (yy + zz)) * s.x;
+			item.world[0][1] = 2.f * (xy - wz) * s.y;
+			item.world[0][2] = 2.f * (xz + wy) * s.z;
+			item.world[0][3] = p.x;
+			item.world[1][0] = 2.f * (xy + wz) * s.x;
+			item.world[1][1] = (1.f - 2.f * (xx + zz)) * s.y;
+			item.world[1][2] = 2.f * (yz - wx) * s.z;
+			item.world[1][3] = p.y;
+			item.world[2][0] = 2.f * (xz - wy) * s.x;
+			item.world[2][1] = 2.f * (yz + wx) * s.y;
+			item.world[2][2] = (1.f - 2.f * (xx + yy)) * s.z;
+			item.world[2][3] = p.z;
+		}
+
+		void extract_chunks(u32 thread) {
+			utl::vector<draw_item>& packet{ packets[thread] };
+
+			while (true) {
+				const u32 chunk{ next_chunk.fetch_add(1, std::memory_order_relaxed) };
+				if (chunk >= chunk_count) break;
+
+				const u32 first{ chunk * chunk_size };
+				const u32 end{ std::min(first + chunk_size, job_renderables.count) };
+				const u32 offset{ (u32)packet.size() };
+
+				for (u32 i{ first }; i < end; i++) {
+					if (!job_renderables.visible[i]) continue;
+					packet.emplace_back();
+					build_item(packet.back(), i);
+				}
+
+				chunk_outputs[chunk] = { thread, offset, (u32)packet.size() - offset };
+			}
+		}
+
+		void worker_loop(u32 thread, u64 generation) {
+			while (true) {
+				{
+					std::unique_lock<std::mutex> lock{ job_mutex };
+					job_signal.wait(lock, [generation] { return stopping || job_generation != generation; });
+					if (stopping) return;
+					generation = job_generation;
+				}
+
+				extract_chunks(thread);
+				busy_workers.fetch_sub(1, std::memory_order_release);
+			}
+		}
+
+		void sort(utl::vector<draw_item>& list) {
+			u32 count{ 0 };
+			for (const chunk_output& chunk : chunk_outputs) count += chunk.count;
+			sort_entries[0].resize(count);
+			sort_entries[1].resize(count);
+			memset(histograms, 0, sizeof(histograms));
+
+			// Take the draws in chunk order, so that the list doesn't depend on which thread took which chunk, and count
+			// the digits of every pass in one go
+			u32 index{ 0 };
+			for (const chunk_output& chunk : chunk_outputs) {
+				const draw_item* const items{ packets[chunk.thread].data() + chunk.offset };
+				for (u32 i{ 0 }; i < chunk.count; i++) {
+					const u64 key{ items[i].key };
+					sort_entries[0][index++] = { key, &items[i] };
+					for (u32 pass{ 0 }; pass < radix_passes; pass++) ++histograms[pass][(key >> (pass * radix_bits)) & (radix_size - 1)];
+				}
+			}
+
+			// Sort the keys with their indices, starting with the lowest digit. Passes where every key has the same
+			// digit are skipped, which are most of them when there are few meshes and materials
+			u32 from{ 0 };
+			for (u32 pass{ 0 }; pass < radix_passes && count; pass++) {
+				u32* const histogram{ histograms[pass] };
+				const u32 shift{ pass * radix_bits };
+				if (histogram[(sort_entries[from][0].key >> shift) & (radix_size - 1)] == count) continue;
+
+				u32 offset{ 0 };
+				for (u32 digit{ 0 }; digit < radix_size; digit++) {
+					const u32 size{ histogram[digit] };
+					histogram[digit] = offset;
+					offset += size;
+				}
+
+				const sort_entry* const in{ sort_entries[from].data() };
+				sort_entry* const out{ sort_entries[from ^ 1].data() };
+				for (u32 i{ 0 }; i < count; i++) out[histogram[(in[i].key >> shift) & (radix_size - 1)]++] = in[i];
+				from ^= 1;
+			}
+
+			// Copy the draws themselves only once, from the packets straight into the list
+			list.resize(count);
+			for (u32 i{ 0 }; i < count; i++) list[i] = *sort_entries[from][i].item;
+		}
+	}
+
+	void initialize(u32 worker_count) {
+		assert(workers.empty());
+		stopping = false;
+		packets.resize(worker_count + 1);
+
+		// Workers start waiting for the job after the last one, which may be from before a shutdown()
+		for (u32 i{ 0 }; i < worker_count; i++) workers.emplace_back(worker_loop, i + 1, job_generation);
+	}
+
+	draw_list extract() {
+		assert(!packets.empty());
+		const u32 buffer{ (u32)(frame & 1) };
+
+		// Wait for the consumer to be done with the list from two frames ago
+		{
+			std::unique_lock<std::mutex> lock{ list_mutex };
+			list_released.wait(lock, [buffer] { return !in_use[buffer]; });
+		}
+
+		// Everything the workers read has to be set up before they are woken
+		job_renderables = renderable::get_data();
+		job_transforms = transform::get_data();
+
+		// A packed world has no transforms to draw, so its list is empty
+		chunk_count = transform::is_packed() ? 0 : (job_renderables.count + chunk_size - 1) / chunk_size;
+		chunk_outputs.resize(chunk_count);
+		for (utl::vector<draw_item>& packet : packets) packet.clear();
+		next_chunk.store(0, std::memory_order_relaxed);
+
+		if (!workers.empty()) {
+			{
+				std::lock_guard<std::mutex> lock{ job_mutex };
+				busy_workers.store((u32)workers.size(), std::memory_order_relaxed);
+				++job_generation;
+			}
+
+			job_signal.notify_all();
+		}
+
+		// Work on the chunks together with the workers, then wait for the ones that are still busy
+		extract_chunks(0);
+		while (busy_workers.load(std::memory_order_acquire)) std::this_thread::yield();
+
+		utl::vector<draw_item>& list{ lists[buffer] };
+		sort(list);
+
+		{
+			std::lock_guard<std::mutex> lock{ list_mutex };
+			in_use[buffer] = true;
+		}
+
+		return { list.data(), (u32)list.size(), buffer, frame++ };
+	}
+
+	void release(const draw_list& list) {
+		assert(list.buffer < 2);
+
+		{
+			std::lock_guard<std::mutex> lock{ list_mutex };
+			assert(in_use[list.buffer]);
+			in_use[list.buffer] = false;
+		}
+
+		list_released.notify_all();
+	}
+
+	void shutdown() {
+		{
+			std::lock_guard<std::mutex> lock{ job_mutex };
+			stopping = true;
+		}
+
+		job_signal.notify_all();
+		for (std::thread& worker : workers) worker.join();
+		workers.clear();
+
+		packets.clear();
+		for (u32 i{ 0 }; i < 2; i++) {
+			lists[i].clear();
+			in_use[i] = false;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+#include "../Common/CommonHeaders.h"
+
+namespace revengine::extraction {
+	// Render extraction turns the visible renderables into a draw list: one item per draw with its sort key and world
+	// matrix, sorted by key so that draws that share a material end up next to each other. Renderers and exporters
+	// only read draw lists and never walk grievances themselves.
+	//
+	// There are two draw lists. While a consumer reads the list of one frame, the simulation can go on with the next
+	// frame and extract into the other list. A consumer hands a list back with release() when it's done with it
+
+	// 64 bytes, so that each item is one cache line
+	struct draw_item {
+		u64 key; // renderable::make_key()
+		u32 grievance; // The index of the grievance
+		u32 reserved;
+		f32 world[3][4]; // The rows of the affine world matrix, which transforms column vectors (x, y, z, 1)
+	};
+
+	static_assert(sizeof(draw_item) == 64, "Draw items should fill one cache line");
+
+	struct draw_list {
+		const draw_item* items{ nullptr };
+		u32 count{ 0 };
+		u32 buffer{ 0 }; // Which of the two lists this is
+		u64 frame{ 0 };
+	};
+
+	/// <summary>
+	/// Start the threads that extract draws together with the thread that calls extract()
+	/// </summary>
+	/// <param name="worker_count">The amount of worker threads, which may be 0 to extract on the calling thread only</param>
+	void initialize(u32 worker_count);
+
+	/// <summary>
+	/// Extract the visible renderables into a sorted draw list. Each thread gathers draws into its own packets, and
+	/// the packets are then sorted into one list with a radix sort. Waits if the consumer still has both lists. The list
+	/// is empty while the transforms are packed
+	/// </summary>
+	/// <returns>The draw list, which stays valid until it's released</returns>
+	draw_list extract();
+
+	/// <summary>
+	/// Hand a draw list back so that it can be filled again. Can be called from any thread
+	/// </summary>
+	void release(const draw_list& list);
+	void shutdown();
+}
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include "Resource.h"
+#include "../Platform/File.h"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace revengine::resource {
+	// Anonymous namespace
+	namespace {
+		struct pending_callback {
+			load_callback callback;
+			void* user_data;
+		};
+
+		// Resources are kept in slots that are indexed by the index part of their ID, like grievances
+		struct slot {
+			std::string path;
+			const detail::type_info* type{ nullptr };
+			void* resource{ nullptr };
+			u64 size{ 0 };
+			u32 ref_count{ 0 };
+			state load_state{ state::loading };
+			bool in_use{ false };
+			utl::vector<pending_callback> callbacks;
+
+			// Unreferenced resources that finished loading are in a list ordered from least to most recently used
+			u32 lru_prev{ u32_invalid_id };
+			u32 lru_next{ u32_invalid_id };
+			bool in_lru{ false };
+		};
+
+		struct load_job {
+			resource_id id;
+			std::string path;
+			const detail::type_info* type;
+		};
+
+		struct load_result {
+			resource_id id;
+			void* resource;
+			u64 size;
+		};
+
+		utl::vector<slot> slots;
+		utl::vector<id::generation_type> generations;
+		utl::deque<resource_id> free_ids;
+		std::unordered_map<std::string, resource_id> paths;
+
+		u32 lru_head{ u32_invalid_id };
+		u32 lru_tail{ u32_invalid_id };
+		u64 used{ 0 };
+		u64 memory_budget{ 0 };
+
+		// Callbacks of resources that were already done when they were asked for, called during the next update
+		utl::vector<std::pair<resource_id, pending_callback>> deferred_callbacks;
+		utl::vector<pending_callback> callbacks_scratch;
+
+		// Jobs go to the workers through one queue, and results come back through another
+		std::mutex job_mutex;
+		std::condition_variable job_signal;
+		utl::deque<load_job> jobs;
+		std::mutex result_mutex;
+		utl::vector<load_result> results;
+		utl::vector<load_result> results_scratch;
+		utl::vector<std::thread> workers;
+		bool stopping{ false };
+
+		bool exists(resource_id id) {
+			assert(id::is_valid(id));
+			const id::id_type index{ id::index(id) };
+			return index < generations.size() && generations[index] == id::generation(id) && slots[index].in_use;
+		}
+
+		slot& get_slot(resource_id id) {
+			assert(exists(id));
+			return slots[id::index(id)];
+		}
+
+		void lru_remove(u32 index) {
+			slot& s{ slots[index] };
+			assert(s.in_lru);
+
+			if (s.lru_prev != u32_invalid_id) slots[s.lru_prev].lru_next = s.lru_next;
+			else lru_head = s.lru_next;
+			if (s.lru_next != u32_invalid_id) slots[s.lru_next].lru_prev = s.lru_prev;
+			else lru_tail = s.lru_prev;
+
+			s.lru_prev = u32_invalid_id;
+			s.lru_next = u32_invalid_id;
+			s.in_lru = false;
+		}
+
+		void lru_push(u32 index) {
+			slot& s{ slots[index] };
+			assert(!s.in_lru && !s.ref_count && s.load_state != state::loading);
+
+			// The most recently used resource goes to the back
+			s.lru_prev = lru_tail;
+			s.lru_next = u32_invalid_id;
+			if (lru_tail != u32_invalid_id) slots[lru_tail].lru_next = index;
+			else lru_head = index;
+			lru_tail = index;
+			s.in_lru = true;
+		}
+
+		void free_slot(u32 index) {
+			slot& s{ slots[index] };
+			assert(!s.ref_count && !s.in_lru && s.load_state != state::loading);
+
+			if (s.resource) {
+				s.type->unload(s.resource);
+				assert(used >= s.size);
+				used -= s.size;
+			}
+
+			paths.erase(s.path);
+			const resource_id id{ (id::id_type)index | ((id::id_type)generations[index] << id::detail::index_bits) };
+			s = {};
+
+			// Recycle the ID, unless the slot has used up all of its generations
+			if (id::can_recycle(id)) free_ids.push_back(id);
+		}
+
+		void evict() {
+			// Unload the least recently used resources until the rest fits into the budget
+			while (used > memory_budget && lru_head != u32_invalid_id) {
+				const u32 index{ lru_head };
+				lru_remove(index);
+				free_slot(index);
+			}
+		}
+
+		void worker_loop() {
+			while (true) {
+				load_job job;
+				{
+					std::unique_lock<std::mutex> lock{ job_mutex };
+					job_signal.wait(lock, [] { return stopping || !jobs.empty(); });
+					if (stopping) return;
+
+					job = std::move(jobs.front());
+					jobs.pop_front();
+				}
+
+				// Map the file and let the resource type build itself from the bytes
+				load_result result{ job.id, nullptr, 0 };
+				platform::mapped_file file{};
+				if (platform::map_file(job.path.c_str(), file)) {
+					result.resource = job.type->load(file.data, file.size);
+					result.size = result.resource ? file.size : 0;
+					platform::unmap_file(file);
+				}
+
+				std::lock_guard<std::mutex> lock{ result_mutex };
+				results.push_back(result);
+			}
+		}
+
+		resource_id create_slot() {
+			resource_id id;
+
+			if (free_ids.size() > id::min_deleted_elements) {
+				// Reuse a slot with a new generation
+				id = free_ids.front();
+				free_ids.pop_front();
+				id = resource_id{ id::new_generation(id) };
+				++generations[id::index(id)];
+			}
+			else {
+				// Stop before the index runs into the generation bits
+				if (!id::can_add_slots(slots.size())) {
+					assert(!"Out of resource IDs");
+					return resource_id{ id::invalid_id };
+				}
+
+				id = resource_id{ (id::id_type)slots.size() };
+				slots.emplace_back();
+				generations.push_back(0);
+			}
+
+			slots[id::index(id)].in_use = true;
+			return id;
+		}
+	}
+
+	namespace detail {
+		resource_id acquire(const char* path, const type_info* type, load_callback callback, void* user_data) {
+			assert(path && type);
+
+			// Hand out the resource that was already loaded from this path
+			auto it{ paths.find(path) };
+			if (it != paths.end()) {
+				slot& s{ get_slot(it->second) };
+				assert(s.type == type);
+
+				if (callback) {
+					if (s.load_state == state::loading) s.callbacks.push_back({ callback, user_data });
+					else deferred_callbacks.push_back({ it->second, { callback, user_data } });
+				}
+
+				return it->second;
+			}
+
+			const resource_id id{ create_slot() };
+			if (!id::is_valid(id)) return id;
+
+			slot& s{ slots[id::index(id)] };
+			s.path = path;
+			s.type = type;
+			s.load_state = state::loading;
+			if (callback) s.callbacks.push_back({ callback, user_data });
+			paths.emplace(s.path, id);
+
+			{
+				std::lock_guard<std::mutex> lock{ job_mutex };
+				assert(!workers.empty());
+				jobs.push_back({ id, s.path, type });
+			}
+
+			job_signal.notify_one();
+			return id;
+		}
+
+		void add_ref(resource_id id) {
+			slot& s{ get_slot(id) };
+			if (s.in_lru) lru_remove(id::index(id));
+			++s.ref_count;
+		}
+
+		void release(resource_id id) {
+			slot& s{ get_slot(id) };
+			assert(s.ref_count);
+			if (--s.ref_count) return;
+
+			// Keep resources that are done loading around until the budget needs their memory. Failed ones hold no
+			// memory, and are dropped so that they can be tried again. Resources that are still loading are handled
+			// once they're done
+			if (s.load_state == state::ready) lru_push(id::index(id));
+			else if (s.load_state == state::failed) free_slot(id::index(id));
+		}
+
+		const void* get(resource_id id, const type_info* type) {
+			const slot& s{ get_slot(id) };
+			assert(s.type == type);
+			return s.load_state == state::ready ? s.resource : nullptr;
+		}
+	}
+
+	state get_state(resource_id id) {
+		return get_slot(id).load_state;
+	}
+
+	void initialize(u32 worker_count, u64 budget) {
+		assert(workers.empty() && worker_count);
+		memory_budget = budget;
+		stopping = false;
+
+		for (u32 i{ 0 }; i < worker_count; i++) workers.emplace_back(worker_loop);
+	}
+
+	void update() {
+		{
+			std::lock_guard<std::mutex> lock{ result_mutex };
+			results_scratch.swap(results);
+		}
+
+		// Hand the finished loads over to their slots
+		for (const load_result& result : results_scratch) {
+			slot& s{ get_slot(result.id) };
+			assert(s.load_state == state::loading);
+
+			s.resource = result.resource;
+			s.size = result.size;
+			s.load_state = result.resource ? state::ready : state::failed;
+			used += s.size;
+
+			// Callbacks may load other resources, which can move the slots, so take them out of the slot first
+			const state load_state{ s.load_state };
+			callbacks_scratch.swap(s.callbacks);
+			for (const pending_callback& c : callbacks_scratch) c.callback(result.id, load_state, c.user_data);
+			callbacks_scratch.clear();
+
+			// A callback may have released the last handle, which already dealt with the slot
+			if (!exists(result.id)) continue;
+
+			// Nobody kept a handle to it while it was loading
+			slot& done{ get_slot(result.id) };
+			if (!done.ref_count && !done.in_lru) {
+				if (done.load_state == state::ready) lru_push(id::index(result.id));
+				else free_slot(id::index(result.id));
+			}
+		}
+
+		results_scratch.clear();
+
+		// Call the callbacks of resources that were already done. Their resources may have been unloaded since
+		for (u32 i{ 0 }; i < deferred_callbacks.size(); i++) {
+			const auto [id, c] { deferred_callbacks[i] };
+			if (exists(id)) c.callback(id, get_slot(id).load_state, c.user_data);
+		}
+
+		deferred_callbacks.clear();
+		evict();
+	}
+
+	void shutdown() {
+		{
+			std::lock_guard<std::mutex> lock{ job_mutex };
+			stopping = true;
+			jobs.clear();
+		}
+
+		job_signal.notify_all();
+		for (std::thread& worker : workers) worker.join();
+		workers.clear();
+
+		// Unload resources that finished after the last update, then everything else
+		for (const load_result& result : results) {
+			if (result.resource) get_slot(result.id).type->unload(result.resource);
+		}
+
+		for (slot& s : slots) {
+			if (s.resource) s.type->unload(s.resource);
+		}
+
+		results.clear();
+		slots.clear();
+		generations.clear();
+		free_ids.clear();
+		paths.clear();
+		deferred_callbacks.clear();
+		lru_head = u32_invalid_id;
+		lru_tail = u32_invalid_id;
+		used = 0;
+	}
+
+	void set_budget(u64 budget) {
+		memory_budget = budget;
+	}
+
+	u64 memory_used() {
+		return used;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+#include "../EngineAPI/Resource.h"
+
+namespace revengine::resource {
+	/// <summary>
+	/// Start the worker threads that load resources
+	/// </summary>
+	/// <param name="worker_count">The amount of worker threads</param>
+	/// <param name="budget">The amount of bytes that loaded resources may use before unreferenced ones are unloaded</param>
+	void initialize(u32 worker_count, u64 budget);
+
+	/// <summary>
+	/// Take the finished loads from the workers, call the load callbacks and unload resources to stay within the budget.
+	/// Called once per frame
+	/// </summary>
+	void update();
+
+	/// <summary>
+	/// Stop the workers and unload every resource. Handles that are still alive must not be used afterwards
+	/// </summary>
+	void shutdown();
+
+	void set_budget(u64 budget);
+	u64 memory_used();
+}
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include "TransformReplication.h"
+#include "../Components/Grievance.h"
+#include "../Components/Transform.h"
+#include "../Utilities/BitStream.h"
+#include "../Utilities/Quantization.h"
+#include <cstring>
+
+namespace revengine::replication {
+	// Anonymous namespace
+	namespace {
+		// Bits of the component mask that is written for transforms that changed
+		enum component : u32 {
+			position = 0x01,
+			rotation = 0x02,
+			scale = 0x04,
+		};
+
+		// Values that follow from the config and are needed by both the encoder and the decoder
+		struct layout {
+			u32 position_half_steps;
+			u32 position_bits;
+			u32 scale_half_steps;
+			u32 scale_bits;
+			u32 rotation_bits;
+			u32 delta_bits;
+		};
+
+		layout get_layout(const config& config) {
+			assert(config.position_precision > 0.f && config.scale_precision > 0.f);
+			assert(config.position_range / config.position_precision < (f32)(1u << 30));
+			assert(config.scale_range / config.scale_precision < (f32)(1u << 30));
+			assert(config.rotation_bits >= 2 && config.rotation_bits <= utl::max_smallest_three_bits);
+			assert(config.delta_bits > 0 && config.delta_bits < 32);
+
+			layout l{};
+			l.position_half_steps = (u32)std::ceil(config.position_range / config.position_precision);
+			l.position_bits = utl::bits_for_value(2 * l.position_half_steps);
+			l.scale_half_steps = (u32)std::ceil(config.scale_range / config.scale_precision);
+			l.scale_bits = utl::bits_for_value(2 * l.scale_half_steps);
+			l.rotation_bits = 2 + 3 * config.rotation_bits;
+			l.delta_bits = config.delta_bits;
+			return l;
+		}
+
+		bool by_index(id::id_type a, id::id_type b) {
+			return id::index(a) < id::index(b);
+		}
+
+		u32 get_mask(const quantized_transform& a, const quantized_transform& b) {
+			u32 mask{ 0 };
+			if (memcmp(a.position, b.position, sizeof(a.position))) mask |= component::position;
+			if (a.rotation != b.rotation) mask |= component::rotation;
+			if (memcmp(a.scale, b.scale, sizeof(a.scale))) mask |= component::scale;
+			return mask;
+		}
+
+		void write_position(utl::bit_writer& w, const layout& l, const u32* position, const u32* base) {
+			for (u32 i{ 0 }; i < 3; i++) {
+				if (base) {
+					// Zigzag the difference so that small negative changes become small numbers as well
+					const s64 delta{ (s64)position[i] - (s64)base[i] };
+					const u64 zigzag{ delta < 0 ? (u64)(-delta) * 2 - 1 : (u64)delta * 2 };
+					const bool small{ zigzag < (u64{ 1 } << l.delta_bits) };
+					w.write_bool(small);
+
+					if (small) {
+						w.write(zigzag, l.delta_bits);
+						continue;
+					}
+				}
+
+				w.write(position[i], l.position_bits);
+			}
+		}
+
+		void read_position(utl::bit_reader& r, const layout& l, u32* position, const u32* base) {
+			for (u32 i{ 0 }; i < 3; i++) {
+				if (base && r.read_bool()) {
+					const u64 zigzag{ r.read(l.delta_bits) };
+					const s64 delta{ zigzag & 1 ? -(s64)((zigzag + 1) / 2) : (s64)(zigzag / 2) };
+					position[i] = (u32)((s64)base[i] + delta);
+				}
+				else {
+					position[i] = (u32)r.read(l.position_bits);
+				}
+			}
+		}
+
+		void write_transform(utl::bit_writer& w, const layout& l, u32 mask, const quantized_transform& t, const quantized_transform* base) {
+			if (mask & component::position) write_position(w, l, t.position, base ? base->position : nullptr);
+			if (mask & component::rotation) w.write(t.rotation, l.rotation_bits);
+			if (mask & component::scale) {
+				for (u32 i{ 0 }; i < 3; i++) w.write(t.scale[i], l.scale_bits);
+			}
+		}
+
+		void read_transform(utl::bit_reader& r, const layout& l, u32 mask, quantized_transform& t, const quantized_transform* base) {
+			// Start from the baseline, so that only the components that changed have to be read
+			if (base) t = *base;
+			if (mask & component::position) read_position(r, l, t.position, base ? base->position : nullptr);
+			if (mask & component::rotation) t.rotation = (u32)r.read(l.rotation_bits);
+			if (mask & component::scale) {
+				for (u32 i{ 0 }; i < 3; i++) t.scale[i] = (u32)r.read(l.scale_bits);
+			}
+		}
+	}
+
+	void capture(const grievance::grievance_id* ids, u32 count, transform_state& state) {
+		state.ids.resize(count);
+		for (u32 i{ 0 }; i < count; i++) state.ids[i] = ids[i];
+		std::sort(state.ids.begin(), state.ids.end(), by_index);
+
+		state.positions.resize(count);
+		state.rotations.resize(count);
+		state.scales.resize(count);
+
+		for (u32 i{ 0 }; i < count; i++) {
+			const grievance::grievance g{ grievance::grievance_id{ state.ids[i] } };
+			assert(grievance::is_alive(g.get_id()));
+			const transform::motivator t{ g.transform() };
+			state.positions[i] = t.position();
+			state.rotations[i] = t.rotation();
+			state.scales[i] = t.scale();
+		}
+	}
+
+	void quantize(const config& config, const transform_state& state, quantized_state& quantized) {
+		const layout l{ get_layout(config) };
+		const u32 count{ (u32)state.ids.size() };
+		assert(state.positions.size() == count && state.rotations.size() == count && state.scales.size() == count);
+
+		quantized.ids = state.ids;
+		quantized.transforms.resize(count);
+
+		for (u32 i{ 0 }; i < count; i++) {
+			quantized_transform& t{ quantized.transforms[i] };
+			const f32* const position{ &state.positions[i].x };
+			const f32* const scale{ &state.scales[i].x };
+
+			for (u32 j{ 0 }; j < 3; j++) {
+				t.position[j] = utl::quantize_signed(position[j], config.position_precision, l.position_half_steps);
+				t.scale[j] = utl::quantize_signed(scale[j], config.scale_precision, l.scale_half_steps);
+			}
+
+			t.rotation = utl::pack_smallest_three(&state.rotations[i].x, config.rotation_bits);
+		}
+	}
+
+	void dequantize(const config& config, const quantized_state& quantized, transform_state& state) {
+		const layout l{ get_layout(config) };
+		const u32 count{ (u32)quantized.ids.size() };
+		state.ids = quantized.ids;
+		state.positions.resize(count);
+		state.rotations.resize(count);
+		state.scales.resize(count);
+
+		for (u32 i{ 0 }; i < count; i++) {
+			const quantized_transform& t{ quantized.transforms[i] };
+			f32* const position{ &state.positions[i].x };
+			f32* const scale{ &state.scales[i].x };
+
+			for (u32 j{ 0 }; j < 3; j++) {
+				position[j] = utl::dequantize_signed(t.position[j], config.position_precision, l.position_half_steps);
+				scale[j] = utl::dequantize_signed(t.scale[j], config.scale_precision, l.scale_half_steps);
+			}
+
+			utl::unpack_smallest_three(t.rotation, config.rotation_bits, &state.rotations[i].x);
+		}
+	}
+
+	u64 encode(const config& config, const quantized_state& state, const quantized_state& baseline, utl::vector<u8>& packet) {
+		const layout l{ get_layout(config) };
+		const u32 count{ (u32)state.ids.size() };
+		utl::bit_writer w{ packet };
+
+		// When the set of grievances is the same as in the baseline, which is the usual case, the ids aren't sent
+		const bool same_ids{ state.ids == baseline.ids };
+		w.write_bool(same_ids);
+
+		if (!same_ids) {
+			// Send the ids as the difference in index to the previous id, followed by the generation
+			w.write_compact(count);
+			id::id_type previous{ 0 };
+			for (id::id_type id : state.ids) {
+				assert(id::index(id) >= previous);
+				w.write_compact((u32)(id::index(id) - previous));
+				w.write(id::generation(id), id::detail::generation_bits);
+				previous = id::index(id);
+			}
+		}
+
+		// Walk both states in index order to find each grievance's baseline
+		u32 base{ 0 };
+		const u32 base_count{ (u32)baseline.ids.size() };
+
+		for (u32 i{ 0 }; i < count; i++) {
+			const id::id_type id{ state.ids[i] };
+			while (base < base_count && id::index(baseline.ids[base]) < id::index(id)) ++base;
+			const quantized_transform* const base_transform{
+				base < base_count && baseline.ids[base] == id ? &baseline.transforms[base] : nullptr };
+
+			const quantized_transform& t{ state.transforms[i] };
+			u32 mask{ component::position | component::rotation | component::scale };
+
+			// Grievances in the baseline only send the components that changed
+			if (base_transform) {
+				mask = get_mask(t, *base_transform);
+				w.write_bool(mask != 0);
+				if (!mask) continue;
+				w.write(mask, 3);
+			}
+
+			write_transform(w, l, mask, t, base_transform);
+		}
+
+		return w.bit_count();
+	}
+
+	bool decode(const config& config, const u8* packet, u32 size, const quantized_state& baseline, quantized_state& state) {
+		const layout l{ get_layout(config) };
+		utl::bit_reader r{ packet, size };
+
+		if (r.read_bool()) {
+			state.ids = baseline.ids;
+		}
+		else {
+			// Every grievance takes at least a bit, so a larger count can only come from a broken packet
+			const u32 count{ r.read_compact() };
+			if (r.failed() || count > (u64)size * 8) return false;
+
+			state.ids.resize(count);
+			id::id_type previous{ 0 };
+			for (u32 i{ 0 }; i < count; i++) {
+				const id::id_type index{ previous + r.read_compact() };
+				const id::id_type generation{ (id::id_type)r.read(id::detail::generation_bits) };
+
+				// Indices have to be ascending and unique, and stay clear of invalid_id
+				if (r.failed() || index >= id::detail::index_mask || (i && index <= previous)) return false;
+
+				state.ids[i] = index | (generation << id::detail::index_bits);
+				previous = index;
+			}
+		}
+
+		const u32 count{ (u32)state.ids.size() };
+		state.transforms.resize(count);
+
+		u32 base{ 0 };
+		const u32 base_count{ (u32)baseline.ids.size() };
+
+		for (u32 i{ 0 }; i < count; i++) {
+			const id::id_type id{ state.ids[i] };
+			while (base < base_count && id::index(baseline.ids[base]) < id::index(id)) ++base;
+			const quantized_transform* const base_transform{
+				base < base_count && baseline.ids[base] == id ? &baseline.transforms[base] : nullptr };
+
+			u32 mask{ component::position | component::rotation | component::scale };
+			if (base_transform) {
+				mask = r.read_bool() ? (u32)r.read(3) : 0;
+			}
+
+			read_transform(r, l, mask, state.transforms[i], base_transform);
+			if (r.failed()) return false;
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+#include "../Common/CommonHeaders.h"
+#include "../Common/Id.h"
+#include "../EngineAPI/Grievance.h"
+
+namespace revengine::replication {
+	// Transforms are sent over the network as quantized values: positions and scales are rounded to a fixed
+	// precision inside a fixed range, and rotations are packed with the smallest-three method. A packet is encoded
+	// against a baseline, which is the last state the receiver has confirmed. Transforms that didn't change cost one
+	// bit, small position changes are sent as deltas, and the rest are sent in full. Both sides have to use the same
+	// config and the same baseline.
+	struct config {
+		f32 position_precision{ 0.001f }; // The size of one position step in world units
+		f32 position_range{ 8192.f }; // Positions are clamped to [-range, range] on every axis
+		f32 scale_precision{ 0.001f };
+		f32 scale_range{ 64.f };
+		u32 rotation_bits{ 10 }; // Bits for each of the three stored quaternion components
+		u32 delta_bits{ 8 }; // Position changes that fit in this many bits are sent as deltas
+	};
+
+	// The transforms of a set of grievances, ordered by grievance index
+	struct transform_state {
+		utl::vector<id::id_type> ids;
+		utl::vector<math::v3> positions;
+		utl::vector<math::v4> rotations;
+		utl::vector<math::v3> scales;
+	};
+
+	struct quantized_transform {
+		u32 position[3];
+		u32 rotation;
+		u32 scale[3];
+	};
+
+	struct quantized_state {
+		utl::vector<id::id_type> ids;
+		utl::vector<quantized_transform> transforms;
+	};
+
+	/// <summary>
+	/// Read the transforms of the given grievances out of the engine
+	/// </summary>
+	/// <param name="ids">The grievances to read - they have to be alive</param>
+	/// <param name="count">The amount of grievances</param>
+	/// <param name="state">The state to write the transforms to, ordered by grievance index</param>
+	void capture(const grievance::grievance_id* ids, u32 count, transform_state& state);
+
+	void quantize(const config& config, const transform_state& state, quantized_state& quantized);
+	void dequantize(const config& config, const quantized_state& quantized, transform_state& state);
+
+	/// <summary>
+	/// Encode a state as the changes to a baseline. Pass an empty baseline to encode the full state
+	/// </summary>
+	/// <param name="packet">The bytes to send</param>
+	/// <returns>The size of the packet in bits</returns>
+	u64 encode(const config& config, const quantized_state& state, const quantized_state& baseline, utl::vector<u8>& packet);
+
+	/// <summary>
+	/// Decode a packet that was encoded against the given baseline
+	/// </summary>
+	/// <returns>False if the packet is malformed, in which case the state is left in an unspecified state</returns>
+	bool decode(const config& config, const u8* packet, u32 size, const quantized_state& baseline, quantized_state& state);
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "WorldSnapshot.h"
+#include "../Components/Grievance.h"
+#include "../Components/Transform.h"
+#include "../Components/Script.h"
+#include "../Components/Animation.h"
+#include "../Components/Motion.h"
+#include "../Components/Renderable.h"
+#include "../Components/Lifetime.h"
+
+namespace revengine::snapshot {
+	// Anonymous namespace
+	namespace {
+		// Deltas compare blocks in chunks of this many bytes, and merge neighbouring chunks that changed into one range
+		constexpr u32 delta_chunk_size{ 64 };
+
+		// Scratch snapshots for capturing and restoring deltas, kept around to avoid reallocating
+		world_snapshot delta_scratch;
+	}
+
+	void capture(world_snapshot& snapshot) {
+		writer w{ snapshot };
+
+		// The order here has to match the order in restore()
+		grievance::capture_state(w);
+		transform::capture_state(w);
+		script::capture_state(w);
+		animation::capture_state(w);
+		motion::capture_state(w);
+		renderable::capture_state(w);
+		lifetime::capture_state(w);
+
+		w.finish();
+	}
+
+	void restore(const world_snapshot& snapshot) {
+		reader r{ snapshot };
+		grievance::restore_state(r);
+		transform::restore_state(r);
+		script::restore_state(r);
+		animation::restore_state(r);
+		motion::restore_state(r);
+		renderable::restore_state(r);
+		lifetime::restore_state(r);
+	}
+
+	void capture_delta(const world_snapshot& baseline, delta_snapshot& delta) {
+		capture(delta_scratch);
+
+		delta.block_sizes.clear();
+		delta.ranges.clear();
+		delta.data.clear();
+
+		for (u32 b{ 0 }; b < delta_scratch.blocks.size(); b++) {
+			const utl::vector<u8>& current{ delta_scratch.blocks[b] };
+			const u32 size{ (u32)current.size() };
+			delta.block_sizes.push_back(size);
+
+			// Bytes past the end of the baseline block always count as changed
+			const u32 base_size{ b < baseline.blocks.size() ? (u32)baseline.blocks[b].size() : 0 };
+			const u8* const base{ base_size ? baseline.blocks[b].data() : nullptr };
+
+			for (u32 offset{ 0 }; offset < size; offset += delta_chunk_size) {
+				const u32 chunk{ std::min(delta_chunk_size, size - offset) };
+				const bool changed{ offset + chunk > base_size || memcmp(&current[offset], base + offset, chunk) != 0 };
+				if (!changed) continue;
+
+				// Extend the last range if it ends right where this chunk starts
+				if (!delta.ranges.empty() && delta.ranges.back().block == b &&
+					delta.ranges.back().offset + delta.ranges.back().size == offset) {
+					delta.ranges.back().size += chunk;
+				}
+				else {
+					delta.ranges.push_back({ b, offset, chunk });
+				}
+
+				delta.data.insert(delta.data.end(), &current[offset], &current[offset] + chunk);
+			}
+		}
+	}
+
+	void apply_delta(const world_snapshot& baseline, const delta_snapshot& delta, world_snapshot& snapshot) {
+		const u32 count{ (u32)delta.block_sizes.size() };
+		snapshot.blocks.resize(count);
+
+		// Start from the baseline, cut to the sizes the blocks had when the delta was captured
+		for (u32 b{ 0 }; b < count; b++) {
+			utl::vector<u8>& block{ snapshot.blocks[b] };
+			block.resize(delta.block_sizes[b]);
+
+			const u32 base_size{ b < baseline.blocks.size() ? (u32)baseline.blocks[b].size() : 0 };
+			const u32 size{ std::min(base_size, delta.block_sizes[b]) };
+			if (size) memcpy(block.data(), baseline.blocks[b].data(), size);
+		}
+
+		// Copy the changed ranges over
+		const u8* data{ delta.data.data() };
+		for (const delta_snapshot::range& range : delta.ranges) {
+			assert(range.offset + range.size <= snapshot.blocks[range.block].size());
+			memcpy(&snapshot.blocks[range.block][range.offset], data, range.size);
+			data += range.size;
+		}
+	}
+
+	void restore(const world_snapshot& baseline, const delta_snapshot& delta) {
+		apply_delta(baseline, delta, delta_scratch);
+		restore(delta_scratch);
+	}
+}
\ No newline at end of file
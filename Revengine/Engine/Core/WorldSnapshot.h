@@ -0,0 +1,140 @@
+#pragma once
+#include "../Common/CommonHeaders.h"
+#include <cstring>
+#include <type_traits>
+
+namespace revengine::snapshot {
+	// A world snapshot is a copy of the engine's state, taken by copying each of the engine's arrays into its own
+	// block of bytes with one memcpy. Blocks are reused between captures, so capturing into the same snapshot every
+	// frame doesn't allocate once the world stops growing. Script state is copied through the optional serialize()
+	// hook of grievance_script.
+	struct world_snapshot {
+		utl::vector<utl::vector<u8>> blocks;
+	};
+
+	// A snapshot stored as the byte ranges that differ from a baseline snapshot
+	struct delta_snapshot {
+		struct range {
+			u32 block;
+			u32 offset;
+			u32 size;
+		};
+
+		utl::vector<u32> block_sizes;
+		utl::vector<range> ranges;
+		utl::vector<u8> data;
+	};
+
+	class writer {
+	public:
+		explicit writer(world_snapshot& snapshot) : _snapshot{ snapshot } {}
+
+		template<typename T>
+		void write(const utl::vector<T>& v) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			utl::vector<u8>& block{ next_block() };
+			block.resize(v.size() * sizeof(T));
+			if (!v.empty()) memcpy(block.data(), v.data(), block.size());
+		}
+
+		template<typename T>
+		void write(const utl::deque<T>& d) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			utl::vector<u8>& block{ next_block() };
+			block.resize(d.size() * sizeof(T));
+
+			// Deques aren't contiguous, so copy them one element at a time
+			u8* data{ block.data() };
+			for (const T& value : d) {
+				memcpy(data, &value, sizeof(T));
+				data += sizeof(T);
+			}
+		}
+
+		template<typename T>
+		void write_value(const T& value) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			utl::vector<u8>& block{ next_block() };
+			block.resize(sizeof(T));
+			memcpy(block.data(), &value, sizeof(T));
+		}
+
+		utl::vector<u8>& next_block() {
+			if (_block == _snapshot.blocks.size()) _snapshot.blocks.emplace_back();
+			return _snapshot.blocks[_block++];
+		}
+
+		void finish() {
+			// Drop blocks left over from a snapshot that had more of them
+			_snapshot.blocks.resize(_block);
+		}
+
+	private:
+		world_snapshot& _snapshot;
+		u32 _block{ 0 };
+	};
+
+	class reader {
+	public:
+		explicit reader(const world_snapshot& snapshot) : _snapshot{ snapshot } {}
+
+		template<typename T>
+		void read(utl::vector<T>& v) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			const utl::vector<u8>& block{ next_block() };
+			assert(block.size() % sizeof(T) == 0);
+			v.resize(block.size() / sizeof(T));
+			if (!v.empty()) memcpy(v.data(), block.data(), block.size());
+		}
+
+		template<typename T>
+		void read(utl::deque<T>& d) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			const utl::vector<u8>& block{ next_block() };
+			assert(block.size() % sizeof(T) == 0);
+			d.resize(block.size() / sizeof(T));
+
+			const u8* data{ block.data() };
+			for (T& value : d) {
+				memcpy(&value, data, sizeof(T));
+				data += sizeof(T);
+			}
+		}
+
+		template<typename T>
+		void read_value(T& value) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			const utl::vector<u8>& block{ next_block() };
+			assert(block.size() == sizeof(T));
+			memcpy(&value, block.data(), sizeof(T));
+		}
+
+		const utl::vector<u8>& next_block() {
+			assert(_block < _snapshot.blocks.size());
+			return _snapshot.blocks[_block++];
+		}
+
+	private:
+		const world_snapshot& _snapshot;
+		u32 _block{ 0 };
+	};
+
+	void capture(world_snapshot& snapshot);
+	void restore(const world_snapshot& snapshot);
+
+	/// <summary>
+	/// Capture the current world as the changes to a baseline snapshot
+	/// </summary>
+	/// <param name="baseline">The snapshot to compare against</param>
+	/// <param name="delta">The delta to write the changed ranges to</param>
+	void capture_delta(const world_snapshot& baseline, delta_snapshot& delta);
+
+	/// <summary>
+	/// Rebuild the full snapshot that a delta was captured from
+	/// </summary>
+	/// <param name="baseline">The snapshot the delta was captured against</param>
+	/// <param name="delta">The changes to apply to the baseline</param>
+	/// <param name="snapshot">The snapshot to write the result to</param>
+	void apply_delta(const world_snapshot& baseline, const delta_snapshot& delta, world_snapshot& snapshot);
+	void restore(const world_snapshot& baseline, const delta_snapshot& delta);
+}
\ No newline at end of file
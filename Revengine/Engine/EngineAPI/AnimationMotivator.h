@@ -0,0 +1,26 @@
+#pragma once
+#include "../Components/ComponentsCommon.h"
+
+namespace revengine::animation {
+	DEFINE_TYPED_ID(animation_id);
+
+	class motivator final {
+	public:
+		constexpr explicit motivator(animation_id id) : _id{ id } {}
+		constexpr motivator() : _id{ id::invalid_id } {}
+		constexpr animation_id get_id() const { return _id; }
+		constexpr bool is_valid() const { return id::is_valid(_id); }
+
+		f32 time() const;
+		bool is_playing() const;
+
+		/// <summary>
+		/// Change how fast the track plays - 0 pauses it and negative values play it backwards
+		/// </summary>
+		void set_speed(f32 speed) const;
+		void set_time(f32 time) const;
+
+	private:
+		animation_id _id;
+	};
+}
\ No newline at end of file
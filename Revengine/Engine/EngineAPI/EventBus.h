@@ -0,0 +1,110 @@
+#pragma once
+#include "../Components/ComponentsCommon.h"
+#include <type_traits>
+
+namespace revengine::events {
+	// Grievances communicate through typed events instead of calling into each other directly. Events are posted into a
+	// lock-free queue owned by the posting thread, and are only delivered once per frame, when the engine calls dispatch().
+	// At that point every event of a given type is gathered into one contiguous array, so that consumers iterate over
+	// arrays of events instead of receiving them one by one.
+	DEFINE_TYPED_ID(subscription_id);
+
+	/// <summary>
+	/// A read-only view into the events of one type that were delivered by the last dispatch(). Events are ordered by their
+	/// target grievance, and then by the order they were posted in. Broadcast events (without a target) come last.
+	/// </summary>
+	template<typename T>
+	struct event_view {
+		const T* events{ nullptr };
+		const grievance::grievance_id* targets{ nullptr };
+		u32 count{ 0 };
+	};
+
+	template<typename T>
+	using event_handler = void(*)(const T* events, const grievance::grievance_id* targets, u32 count, void* user_data);
+
+	// Use a detail namespace to prevent external use
+	namespace detail {
+		using type_id = u32;
+		using erased_handler = void(*)();
+		using handler_invoker = void(*)(erased_handler handler, const void* events, const grievance::grievance_id* targets,
+			u32 count, void* user_data);
+
+		struct erased_view {
+			const void* events{ nullptr };
+			const grievance::grievance_id* targets{ nullptr };
+			u32 count{ 0 };
+		};
+
+		type_id next_type_id();
+
+		template<typename T>
+		type_id get_type_id() {
+			// RTTI is disabled, so every event type gets a sequential ID the first time it is used
+			static const type_id id{ next_type_id() };
+			return id;
+		}
+
+		template<typename T>
+		void invoke_handler(erased_handler handler, const void* events, const grievance::grievance_id* targets,
+			u32 count, void* user_data) {
+			reinterpret_cast<event_handler<T>>(handler)(static_cast<const T*>(events), targets, count, user_data);
+		}
+
+		bool post(type_id type, u32 size, const void* data, grievance::grievance_id target);
+		subscription_id subscribe(type_id type, u32 size, handler_invoker invoker, erased_handler handler,
+			void* user_data, grievance::grievance_id target);
+		erased_view view(type_id type);
+		erased_view view(type_id type, grievance::grievance_id target);
+	}
+
+	/// <summary>
+	/// Post an event from any thread. The event is copied into the posting thread's queue and will be delivered
+	/// during the next dispatch()
+	/// </summary>
+	/// <param name="event">The event to post - it needs to be trivially copyable</param>
+	/// <param name="target">The grievance the event is meant for, or an invalid ID to broadcast it</param>
+	/// <returns>True if the event was queued, false if the thread's queue is full</returns>
+	template<typename T>
+	bool post(const T& event, grievance::grievance_id target = grievance::grievance_id{ id::invalid_id }) {
+		static_assert(std::is_trivially_copyable_v<T>, "Events are copied as raw bytes and need to be trivially copyable");
+		static_assert(alignof(T) <= 16, "Events can't require more than 16 byte alignment");
+		return detail::post(detail::get_type_id<T>(), (u32)sizeof(T), &event, target);
+	}
+
+	/// <summary>
+	/// Subscribe to all events of a type, or only to the ones targeting a specific grievance. Subscriptions can only be
+	/// changed from the thread that calls dispatch(), and not from within a handler
+	/// </summary>
+	/// <param name="handler">The function that receives the array of events once per dispatch</param>
+	/// <param name="user_data">A pointer that is passed back to the handler</param>
+	/// <param name="target">The grievance to receive events for, or an invalid ID to receive every event of this type</param>
+	/// <returns>The ID of the subscription, to be used with unsubscribe()</returns>
+	template<typename T>
+	subscription_id subscribe(event_handler<T> handler, void* user_data = nullptr,
+		grievance::grievance_id target = grievance::grievance_id{ id::invalid_id }) {
+		assert(handler);
+		return detail::subscribe(detail::get_type_id<T>(), (u32)sizeof(T), &detail::invoke_handler<T>,
+			reinterpret_cast<detail::erased_handler>(handler), user_data, target);
+	}
+
+	void unsubscribe(subscription_id id);
+
+	/// <summary>
+	/// Get all the events of a type that were delivered by the last dispatch(). The view stays valid until the next dispatch()
+	/// </summary>
+	template<typename T>
+	event_view<T> view() {
+		const detail::erased_view v{ detail::view(detail::get_type_id<T>()) };
+		return { static_cast<const T*>(v.events), v.targets, v.count };
+	}
+
+	/// <summary>
+	/// Get the events of a type that were delivered to a specific grievance by the last dispatch()
+	/// </summary>
+	template<typename T>
+	event_view<T> view(grievance::grievance_id target) {
+		const detail::erased_view v{ detail::view(detail::get_type_id<T>(), target) };
+		return { static_cast<const T*>(v.events), v.targets, v.count };
+	}
+}
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 
-#include "..\Components\ComponentsCommon.h"
+#include "../Components/ComponentsCommon.h"
 #include "TransformMotivator.h"
 #include "ScriptMotivator.h"
+#include "AnimationMotivator.h"
+#include "MotionMotivator.h"
+#include "RenderableMotivator.h"
+#include "LifetimeMotivator.h"
 #include <string>
 
 namespace revengine {
@@ -17,6 +21,10 @@ namespace revengine {
 
 			transform::motivator transform() const;
 			script::motivator script() const;
+			animation::motivator animation() const;
+			motion::motivator motion() const;
+			renderable::motivator renderable() const;
+			lifetime::motivator lifetime() const;
 		private:
 			grievance_id _id;
 		};
@@ -28,6 +36,12 @@ namespace revengine {
 			virtual ~grievance_script() = default;
 			virtual void begin_play() {}
 			virtual void update(float) {}
+
+			// Scripts with state that has to survive a game code reload override these. serialize() returns the amount
+			// of bytes the state needs, and only writes it when the buffer is big enough. deserialize() is called on
+			// the new instance with the same bytes
+			virtual u32 serialize(u8* /*buffer*/, u32 /*size*/) const { return 0; }
+			virtual void deserialize(const u8* /*data*/, u32 /*size*/) {}
 		protected:
 			constexpr explicit grievance_script(revengine::grievance::grievance grievance)
 				: revengine::grievance::grievance{ grievance.get_id() } { }
@@ -0,0 +1,20 @@
+#pragma once
+#include "../Components/ComponentsCommon.h"
+
+namespace revengine::lifetime {
+	DEFINE_TYPED_ID(lifetime_id);
+
+	class motivator final {
+	public:
+		constexpr explicit motivator(lifetime_id id) : _id{ id } {}
+		constexpr motivator() : _id{ id::invalid_id } {}
+		constexpr lifetime_id get_id() const { return _id; }
+		constexpr bool is_valid() const { return id::is_valid(_id); }
+
+		f32 remaining() const;
+		void set_remaining(f32 seconds) const;
+
+	private:
+		lifetime_id _id;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+#include "../Common/CommonHeaders.h"
+#include <cstring>
+#include <type_traits>
+
+namespace revengine::log {
+	// Log records are written in binary into a lock-free queue owned by the logging thread: the ID of the format string
+	// and the raw bytes of the arguments. A background thread turns them into text and writes them to the log file,
+	// so logging a message costs about as much as copying its arguments. Format strings use {} as placeholders:
+	//
+	//     LOG_WARNING("Grievance {} has no transform", id);
+	//
+	// Arguments can be numbers, bools, pointers, enums and strings. Strings are copied when logged.
+	enum class level : u8 {
+		info,
+		warning,
+		error,
+	};
+
+	// Use a detail namespace to prevent external use
+	namespace detail {
+		using format_id = u32;
+
+		enum class arg_type : u8 {
+			signed_int,
+			unsigned_int,
+			floating,
+			boolean,
+			pointer,
+			string,
+		};
+
+		format_id register_format(level level, const char* format, const char* file, u32 line);
+		bool is_enabled(level level);
+
+		// Reserve room for a record in the thread's queue. Returns nullptr if the log isn't running or the queue is full
+		u8* begin_record(format_id format, u32 size);
+		void end_record();
+
+		template<typename T>
+		u32 arg_size(const T& value) {
+			using type = std::decay_t<T>;
+			if constexpr (std::is_same_v<type, const char*> || std::is_same_v<type, char*>) {
+				const char* const string{ value };
+				return 1 + sizeof(u32) + (string ? (u32)strlen(string) : 0);
+			}
+			else {
+				return 1 + sizeof(u64);
+			}
+		}
+
+		template<typename T>
+		void write_arg(u8*& data, const T& value) {
+			using type = std::decay_t<T>;
+			arg_type tag;
+			u64 bits{ 0 };
+
+			if constexpr (std::is_same_v<type, const char*> || std::is_same_v<type, char*>) {
+				// Strings are stored as their length followed by the characters
+				const char* const string{ value };
+				const u32 length{ string ? (u32)strlen(string) : 0 };
+				*data++ = (u8)arg_type::string;
+				memcpy(data, &length, sizeof(u32));
+				if (length) memcpy(data + sizeof(u32), string, length);
+				data += sizeof(u32) + length;
+				return;
+			}
+			else if constexpr (std::is_same_v<type, bool>) {
+				tag = arg_type::boolean;
+				bits = value ? 1 : 0;
+			}
+			else if constexpr (std::is_floating_point_v<type>) {
+				tag = arg_type::floating;
+				const double f{ (double)value };
+				memcpy(&bits, &f, sizeof(u64));
+			}
+			else if constexpr (std::is_pointer_v<type>) {
+				tag = arg_type::pointer;
+				bits = (u64)(uintptr_t)value;
+			}
+			else if constexpr (std::is_enum_v<type>) {
+				tag = arg_type::signed_int;
+				bits = (u64)(s64)value;
+			}
+			else if constexpr (std::is_integral_v<type> && std::is_signed_v<type>) {
+				tag = arg_type::signed_int;
+				bits = (u64)(s64)value;
+			}
+			else {
+				// Unsigned numbers, and anything that converts to one, like typed IDs
+				static_assert(std::is_convertible_v<type, u64>, "This type can't be logged");
+				tag = arg_type::unsigned_int;
+				bits = (u64)value;
+			}
+
+			*data++ = (u8)tag;
+			memcpy(data, &bits, sizeof(u64));
+			data += sizeof(u64);
+		}
+
+		template<typename... Args>
+		void write(format_id format, const Args&... args) {
+			const u32 size{ (0u + ... + arg_size(args)) };
+			u8* data{ begin_record(format, size) };
+			if (!data) return;
+
+			(write_arg(data, args), ...);
+			end_record();
+		}
+	}
+}
+
+// Each call site registers its format string once, the first time it is reached
+#define REVENGINE_LOG(lvl, format, ...)																\
+	do {																								\
+		if (revengine::log::detail::is_enabled(lvl)) {													\
+			static const revengine::log::detail::format_id _log_format{									\
+				revengine::log::detail::register_format(lvl, format, __FILE__, __LINE__) };			\
+			revengine::log::detail::write(_log_format, ##__VA_ARGS__);									\
+		}																								\
+	} while (0)
+
+#define LOG_INFO(format, ...) REVENGINE_LOG(revengine::log::level::info, format, ##__VA_ARGS__)
+#define LOG_WARNING(format, ...) REVENGINE_LOG(revengine::log::level::warning, format, ##__VA_ARGS__)
+#define LOG_ERROR(format, ...) REVENGINE_LOG(revengine::log::level::error, format, ##__VA_ARGS__)
\ No newline at end of file
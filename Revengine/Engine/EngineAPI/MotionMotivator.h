@@ -0,0 +1,24 @@
+#pragma once
+#include "../Components/ComponentsCommon.h"
+
+namespace revengine::motion {
+	DEFINE_TYPED_ID(motion_id);
+
+	class motivator final {
+	public:
+		constexpr explicit motivator(motion_id id) : _id{ id } {}
+		constexpr motivator() : _id{ id::invalid_id } {}
+		constexpr motion_id get_id() const { return _id; }
+		constexpr bool is_valid() const { return id::is_valid(_id); }
+
+		math::v3 linear_velocity() const;
+		math::v3 angular_velocity() const;
+		void set_linear_velocity(math::v3 velocity) const;
+		void set_angular_velocity(math::v3 velocity) const;
+		void set_linear_acceleration(math::v3 acceleration) const;
+		void set_angular_acceleration(math::v3 acceleration) const;
+
+	private:
+		motion_id _id;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+#include "../Components/ComponentsCommon.h"
+
+namespace revengine::renderable {
+	DEFINE_TYPED_ID(renderable_id);
+
+	class motivator final {
+	public:
+		constexpr explicit motivator(renderable_id id) : _id{ id } {}
+		constexpr motivator() : _id{ id::invalid_id } {}
+		constexpr renderable_id get_id() const { return _id; }
+		constexpr bool is_valid() const { return id::is_valid(_id); }
+
+		bool is_visible() const;
+		void set_visible(bool visible) const;
+		void set_mesh(u32 mesh) const;
+		void set_material(u32 material) const;
+
+	private:
+		renderable_id _id;
+	};
+}
\ No newline at end of file
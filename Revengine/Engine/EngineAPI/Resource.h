@@ -0,0 +1,115 @@
+#pragma once
+#include "../Components/ComponentsCommon.h"
+
+namespace revengine::resource {
+	// Resources are files that are loaded once and shared. Loading a path that is already loaded, or still loading, gives
+	// back the same resource. Files are memory-mapped and turned into resources on worker threads, so load() never
+	// blocks - the resource can be polled through its handle, or a callback can be passed that is called from
+	// the engine's update once the load is done. Handles count references. Resources that aren't referenced anymore
+	// are kept around in case they are loaded again, until the memory budget is exceeded, and then the least
+	// recently used ones are unloaded first.
+	//
+	// A resource type is any type with a static load function that builds it from the bytes of the file:
+	//
+	//     static T* load(const u8* data, u64 size);
+	//
+	// It runs on a worker thread, should return nullptr on failure, and the result is destroyed with delete.
+	// Handles and load() may only be used from the thread that calls the engine's update.
+	DEFINE_TYPED_ID(resource_id);
+
+	enum class state : u8 {
+		loading,
+		ready,
+		failed,
+	};
+
+	using load_callback = void(*)(resource_id id, state state, void* user_data);
+
+	// Use a detail namespace to prevent external use
+	namespace detail {
+		struct type_info {
+			void* (*load)(const u8* data, u64 size);
+			void (*unload)(void* resource);
+		};
+
+		template<typename T>
+		void* load_resource(const u8* data, u64 size) {
+			return T::load(data, size);
+		}
+
+		template<typename T>
+		void unload_resource(void* resource) {
+			delete static_cast<T*>(resource);
+		}
+
+		template<typename T>
+		const type_info* get_type_info() {
+			static const type_info info{ &load_resource<T>, &unload_resource<T> };
+			return &info;
+		}
+
+		resource_id acquire(const char* path, const type_info* type, load_callback callback, void* user_data);
+		void add_ref(resource_id id);
+		void release(resource_id id);
+		const void* get(resource_id id, const type_info* type);
+	}
+
+	state get_state(resource_id id);
+
+	template<typename T>
+	class handle {
+	public:
+		constexpr handle() : _id{ id::invalid_id } {}
+		explicit handle(resource_id id) : _id{ id } { if (is_valid()) detail::add_ref(_id); }
+		handle(const handle& other) : handle{ other._id } {}
+		handle(handle&& other) noexcept : _id{ other._id } { other._id = resource_id{ id::invalid_id }; }
+		~handle() { reset(); }
+
+		handle& operator=(handle other) {
+			std::swap(_id, other._id);
+			return *this;
+		}
+
+		void reset() {
+			if (is_valid()) detail::release(_id);
+			_id = resource_id{ id::invalid_id };
+		}
+
+		constexpr resource_id get_id() const { return _id; }
+		constexpr bool is_valid() const { return id::is_valid(_id); }
+		bool is_ready() const { return is_valid() && get_state(_id) == state::ready; }
+
+		/// <summary>
+		/// Get the resource, or nullptr if it is still loading or failed to load
+		/// </summary>
+		const T* get() const {
+			return is_valid() ? static_cast<const T*>(detail::get(_id, detail::get_type_info<T>())) : nullptr;
+		}
+
+	private:
+		resource_id _id;
+	};
+
+	/// <summary>
+	/// Start loading a resource, or get the one that was already loaded from the same path
+	/// </summary>
+	/// <param name="path">The path of the file</param>
+	/// <param name="callback">Called from the engine's update once the resource is ready or failed to load. If it already
+	/// was, it is called during the next update</param>
+	/// <param name="user_data">A pointer that is passed back to the callback</param>
+	template<typename T>
+	handle<T> load(const char* path, load_callback callback = nullptr, void* user_data = nullptr) {
+		return handle<T>{ detail::acquire(path, detail::get_type_info<T>(), callback, user_data) };
+	}
+
+	// The bytes of a file, for resources that don't need any processing
+	struct blob {
+		utl::vector<u8> data;
+
+		static blob* load(const u8* data, u64 size) {
+			blob* const b{ new blob{} };
+			b->data.assign(data, data + size);
+			return b;
+		}
+	};
+}
\ No newline at end of file
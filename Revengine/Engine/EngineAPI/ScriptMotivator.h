@@ -1,5 +1,5 @@
 #pragma once
-#include "..\Components\ComponentsCommon.h"
+#include "../Components/ComponentsCommon.h"
 
 namespace revengine::script {
 	DEFINE_TYPED_ID(script_id);
@@ -1,5 +1,5 @@
 #pragma once
-#include "..\Components\ComponentsCommon.h"
+#include "../Components/ComponentsCommon.h"
 
 namespace revengine::transform {
 	DEFINE_TYPED_ID(transform_id);
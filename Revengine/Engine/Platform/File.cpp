@@ -0,0 +1,91 @@
+#include "File.h"
+
+#if defined(_WIN64)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error The platform layer needs to be implemented for this platform
+#endif
+
+namespace revengine::platform {
+#if defined(_WIN64)
+	bool map_file(const char* path, mapped_file& file) {
+		assert(path);
+		file = {};
+
+		HANDLE handle{ CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+		if (handle == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(handle, &size)) {
+			CloseHandle(handle);
+			return false;
+		}
+
+		file.file = handle;
+		file.size = (u64)size.QuadPart;
+
+		// Windows can't map empty files
+		if (!file.size) return true;
+
+		file.mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (file.mapping) file.data = (const u8*)MapViewOfFile(file.mapping, FILE_MAP_READ, 0, 0, 0);
+
+		if (!file.data) {
+			unmap_file(file);
+			return false;
+		}
+
+		return true;
+	}
+
+	void unmap_file(mapped_file& file) {
+		if (file.data) UnmapViewOfFile(file.data);
+		if (file.mapping) CloseHandle(file.mapping);
+		if (file.file) CloseHandle(file.file);
+		file = {};
+	}
+#elif defined(__linux__)
+	bool map_file(const char* path, mapped_file& file) {
+		assert(path);
+		file = {};
+
+		const int fd{ open(path, O_RDONLY) };
+		if (fd < 0) return false;
+
+		struct stat info;
+		if (fstat(fd, &info) != 0) {
+			close(fd);
+			return false;
+		}
+
+		file.size = (u64)info.st_size;
+		if (file.size) {
+			void* const data{ mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0) };
+			if (data == MAP_FAILED) {
+				close(fd);
+				file = {};
+				return false;
+			}
+
+			file.data = (const u8*)data;
+		}
+
+		// The mapping stays valid after the file is closed
+		close(fd);
+		return true;
+	}
+
+	void unmap_file(mapped_file& file) {
+		if (file.data) munmap((void*)file.data, file.size);
+		file = {};
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+#include "../Common/CommonHeaders.h"
+
+namespace revengine::platform {
+	// A read-only view of a whole file, mapped into memory. The OS pages the file in as it is read, so there is no
+	// separate read buffer to fill
+	struct mapped_file {
+		const u8* data{ nullptr };
+		u64 size{ 0 };
+		void* file{ nullptr }; // The native file handle on Windows, unused on Linux
+		void* mapping{ nullptr }; // The native mapping handle on Windows, unused on Linux
+	};
+
+	/// <summary>
+	/// Map a file into memory for reading. Empty files are mapped with a null data pointer
+	/// </summary>
+	/// <param name="path">The path of the file</param>
+	/// <param name="file">The mapping to fill in</param>
+	/// <returns>False if the file couldn't be opened or mapped</returns>
+	bool map_file(const char* path, mapped_file& file);
+	void unmap_file(mapped_file& file);
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "Module.h"
+#include <filesystem>
+
+#if defined(_WIN64)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#elif defined(__linux__)
+#include <dlfcn.h>
+#else
+#error The platform layer needs to be implemented for this platform
+#endif
+
+namespace revengine::platform {
+#if defined(_WIN64)
+	module_handle load_module(const char* path) {
+		assert(path);
+		return (module_handle)LoadLibraryA(path);
+	}
+
+	bool unload_module(module_handle module) {
+		assert(module);
+		return FreeLibrary((HMODULE)module) != 0;
+	}
+
+	void* get_symbol(module_handle module, const char* name) {
+		assert(module && name);
+		return (void*)GetProcAddress((HMODULE)module, name);
+	}
+#elif defined(__linux__)
+	module_handle load_module(const char* path) {
+		assert(path);
+
+		// Resolve every symbol now, so that a broken module fails to load instead of failing later during a call
+		return dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	}
+
+	bool unload_module(module_handle module) {
+		assert(module);
+		return dlclose(module) == 0;
+	}
+
+	void* get_symbol(module_handle module, const char* name) {
+		assert(module && name);
+		return dlsym(module, name);
+	}
+#endif
+
+	module_handle load_module_copy(const char* path, const char* copy_path) {
+		assert(path && copy_path);
+
+		// Overwrite any copy left behind by an earlier session
+		std::error_code error;
+		std::filesystem::copy_file(path, copy_path, std::filesystem::copy_options::overwrite_existing, error);
+		if (error) return nullptr;
+
+		module_handle module{ load_module(copy_path) };
+		if (!module) std::filesystem::remove(copy_path, error);
+		return module;
+	}
+
+	bool unload_module_copy(module_handle module, const char* copy_path) {
+		assert(copy_path);
+		if (!unload_module(module)) return false;
+
+		// The copy is only deleted once it's unloaded, as Windows keeps loaded DLLs locked
+		std::error_code error;
+		std::filesystem::remove(copy_path, error);
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+#include "../Common/CommonHeaders.h"
+
+namespace revengine::platform {
+	// Loading and unloading shared libraries (DLLs on Windows, shared objects on Linux), used for game code.
+	// A module_handle is the native handle of the library - HMODULE on Windows and the dlopen() handle on Linux
+	using module_handle = void*;
+
+	module_handle load_module(const char* path);
+	bool unload_module(module_handle module);
+	void* get_symbol(module_handle module, const char* name);
+
+	/// <summary>
+	/// Copy a module to a new file and load the copy. Windows keeps loaded DLLs locked, and dlopen() hands back the
+	/// already loaded library for a path it has seen, so reloading code that was rebuilt in place needs a fresh file
+	/// </summary>
+	/// <param name="path">The path of the module that was built</param>
+	/// <param name="copy_path">The path to copy the module to before loading it</param>
+	/// <returns>The handle of the loaded copy, or nullptr if copying or loading failed - the copy is deleted then</returns>
+	module_handle load_module_copy(const char* path, const char* copy_path);
+
+	/// <summary>
+	/// Unload a module that was loaded by load_module_copy(), and delete the copy
+	/// </summary>
+	/// <returns>False if the module couldn't be unloaded, in which case the copy is kept</returns>
+	bool unload_module_copy(module_handle module, const char* copy_path);
+}
\ No newline at end of file
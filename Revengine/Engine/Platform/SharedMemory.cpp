@@ -0,0 +1,154 @@
+#include "SharedMemory.h"
+#include <cstdio>
+
+#if defined(_WIN64)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error The platform layer needs to be implemented for this platform
+#endif
+
+namespace revengine::platform {
+#if defined(_WIN64)
+	namespace {
+		bool map(const char* name, u64 size, bool create, shared_memory& memory) {
+			assert(name && size);
+			memory = {};
+			snprintf(memory.name, sizeof(memory.name), "Local\\%s", name);
+
+			if (create) {
+				memory.mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, memory.name);
+
+				// Don't share a mapping that somebody else made
+				if (memory.mapping && GetLastError() == ERROR_ALREADY_EXISTS) {
+					CloseHandle(memory.mapping);
+					memory = {};
+					return false;
+				}
+			}
+			else {
+				memory.mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, memory.name);
+			}
+
+			if (memory.mapping) memory.data = (u8*)MapViewOfFile(memory.mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+
+			if (!memory.data) {
+				close_shared_memory(memory);
+				return false;
+			}
+
+			memory.size = size;
+			memory.owner = create;
+			return true;
+		}
+	}
+
+	bool create_shared_memory(const char* name, u64 size, shared_memory& memory) {
+		// Pages of a new mapping start out as zeros
+		return map(name, size, true, memory);
+	}
+
+	bool open_shared_memory(const char* name, u64 size, shared_memory& memory) {
+		return map(name, size, false, memory);
+	}
+
+	void close_shared_memory(shared_memory& memory) {
+		if (memory.data) UnmapViewOfFile(memory.data);
+		if (memory.mapping) CloseHandle(memory.mapping);
+		memory = {};
+	}
+#elif defined(__linux__)
+	namespace {
+		// Names outlive the processes that made them. The creator holds a lock on the object for as long as it lives,
+		// which the system releases when the process dies, so a name that nobody holds the lock of was left behind
+		int create_object(const char* name) {
+			for (u32 attempt{ 0 }; attempt < 2; attempt++) {
+				const int fd{ shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600) };
+				if (fd >= 0) {
+					// Another creator may have found the object before it was locked, and taken the name over
+					struct stat status {};
+					if (flock(fd, LOCK_EX | LOCK_NB) != 0 || fstat(fd, &status) != 0 || !status.st_nlink) {
+						close(fd);
+						return -1;
+					}
+
+					return fd;
+				}
+
+				if (errno != EEXIST) return -1;
+
+				// Take the name over only if its creator is gone
+				const int existing{ shm_open(name, O_RDWR, 0) };
+				if (existing < 0) continue;
+
+				const bool left_behind{ flock(existing, LOCK_EX | LOCK_NB) == 0 };
+				if (left_behind) shm_unlink(name);
+				close(existing);
+				if (!left_behind) return -1;
+			}
+
+			return -1;
+		}
+
+		bool map(const char* name, u64 size, bool create, shared_memory& memory) {
+			assert(name && size);
+			memory = {};
+			snprintf(memory.name, sizeof(memory.name), "/%s", name);
+
+			const int fd{ create ? create_object(memory.name) : shm_open(memory.name, O_RDWR, 0) };
+			if (fd < 0) return false;
+
+			// A new object is grown to the size with zeros
+			if (create && ftruncate(fd, (off_t)size) != 0) {
+				shm_unlink(memory.name);
+				close(fd);
+				return false;
+			}
+
+			void* const data{ mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) };
+
+			// The mapping stays valid after the descriptor is closed, but the creator keeps it to hold the lock
+			if (!create || data == MAP_FAILED) close(fd);
+
+			if (data == MAP_FAILED) {
+				if (create) shm_unlink(memory.name);
+				memory = {};
+				return false;
+			}
+
+			memory.data = (u8*)data;
+			memory.size = size;
+			memory.descriptor = create ? fd : -1;
+			memory.owner = create;
+			return true;
+		}
+	}
+
+	bool create_shared_memory(const char* name, u64 size, shared_memory& memory) {
+		return map(name, size, true, memory);
+	}
+
+	bool open_shared_memory(const char* name, u64 size, shared_memory& memory) {
+		return map(name, size, false, memory);
+	}
+
+	void close_shared_memory(shared_memory& memory) {
+		if (memory.data) munmap(memory.data, memory.size);
+
+		// Processes that still have it mapped keep their view. The name is removed before the lock is released, so that
+		// nobody takes over a name that is about to go away
+		if (memory.owner) shm_unlink(memory.name);
+		if (memory.descriptor >= 0) close(memory.descriptor);
+		memory = {};
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+#include "../Common/CommonHeaders.h"
+
+namespace revengine::platform {
+	// A block of memory that other processes can map by its name
+	struct shared_memory {
+		u8* data{ nullptr };
+		u64 size{ 0 };
+		void* mapping{ nullptr }; // The native mapping handle on Windows, unused on Linux
+		s32 descriptor{ -1 }; // The creator's descriptor on Linux, which holds the lock that marks the name as in use
+		bool owner{ false }; // The creator removes the name again on Linux
+		char name[64]{};
+	};
+
+	/// <summary>
+	/// Create a named block of shared memory, filled with zeros
+	/// </summary>
+	/// <param name="name">The name other processes open the memory by, without any slashes</param>
+	/// <param name="size">The amount of bytes</param>
+	/// <param name="memory">The mapping to fill in</param>
+	/// <returns>False if the memory couldn't be created or mapped, or if another process uses the name. On Linux, a name
+	/// that was left behind by a process that crashed is taken over</returns>
+	bool create_shared_memory(const char* name, u64 size, shared_memory& memory);
+
+	/// <summary>
+	/// Map a block of shared memory that another process created
+	/// </summary>
+	/// <param name="name">The name the memory was created with</param>
+	/// <param name="size">The amount of bytes to map</param>
+	/// <param name="memory">The mapping to fill in</param>
+	/// <returns>False if there is no shared memory with the name, or if it couldn't be mapped</returns>
+	bool open_shared_memory(const char* name, u64 size, shared_memory& memory);
+	void close_shared_memory(shared_memory& memory);
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+#include "../Common/CommonHeaders.h"
+
+namespace revengine::utl {
+	// Writes values with an arbitrary amount of bits into a byte array, lowest bits first
+	class bit_writer {
+	public:
+		explicit bit_writer(utl::vector<u8>& buffer) : _buffer{ buffer } { _buffer.clear(); }
+
+		void write(u64 value, u32 bits) {
+			assert(bits <= 64);
+			assert(bits == 64 || value < (u64{ 1 } << bits));
+
+			while (bits) {
+				// Start a new byte when the current one is full
+				if (!_free_bits) {
+					_buffer.push_back(0);
+					_free_bits = 8;
+				}
+
+				// Fill the rest of the current byte with the lowest bits of the value
+				const u32 count{ std::min(bits, _free_bits) };
+				const u8 part{ (u8)(value & ((1u << count) - 1)) };
+				_buffer.back() |= (u8)(part << (8 - _free_bits));
+
+				value >>= count;
+				bits -= count;
+				_free_bits -= count;
+				_bit_count += count;
+			}
+		}
+
+		void write_bool(bool value) {
+			write(value ? 1 : 0, 1);
+		}
+
+		/// <summary>
+		/// Write an unsigned value using 4, 8, 16 or 32 bits plus a 2 bit prefix that says which
+		/// </summary>
+		void write_compact(u32 value) {
+			const u32 size_class{ value < (1u << 4) ? 0u : value < (1u << 8) ? 1u : value < (1u << 16) ? 2u : 3u };
+			write(size_class, 2);
+			write(value, 4u << size_class);
+		}
+
+		constexpr u64 bit_count() const { return _bit_count; }
+
+	private:
+		utl::vector<u8>& _buffer;
+		u32 _free_bits{ 0 };
+		u64 _bit_count{ 0 };
+	};
+
+	// Reads values written by bit_writer. Reading past the end of the data returns zeros and marks the reader as failed,
+	// so that data from the network can't make the reader go out of bounds
+	class bit_reader {
+	public:
+		bit_reader(const u8* data, u32 size) : _data{ data }, _size{ size } {}
+
+		u64 read(u32 bits) {
+			assert(bits <= 64);
+			u64 value{ 0 };
+			u32 shift{ 0 };
+
+			while (bits) {
+				const u64 byte{ _position >> 3 };
+				if (byte >= _size) {
+					_failed = true;
+					return 0;
+				}
+
+				// Take as many bits as are left in the current byte
+				const u32 offset{ (u32)(_position & 7) };
+				const u32 count{ std::min(bits, 8 - offset) };
+				const u64 part{ (u64)((_data[byte] >> offset) & ((1u << count) - 1)) };
+				value |= part << shift;
+
+				shift += count;
+				bits -= count;
+				_position += count;
+			}
+
+			return value;
+		}
+
+		bool read_bool() {
+			return read(1) != 0;
+		}
+
+		u32 read_compact() {
+			const u32 size_class{ (u32)read(2) };
+			return (u32)read(4u << size_class);
+		}
+
+		constexpr bool failed() const { return _failed; }
+
+	private:
+		const u8* const _data;
+		const u32 _size;
+		u64 _position{ 0 };
+		bool _failed{ false };
+	};
+}
\ No newline at end of file
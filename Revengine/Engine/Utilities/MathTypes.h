@@ -4,7 +4,6 @@
 namespace revengine::math {
 	constexpr float pi = 3.1415926535897932384626433832795f;
 	constexpr float epsilon = 1e-5f;
-#if defined(_WIN64)
 	using v2 = DirectX::XMFLOAT2;
 	using v2a = DirectX::XMFLOAT2A;
 	using v3 = DirectX::XMFLOAT3;
@@ -20,5 +19,4 @@ namespace revengine::math {
 	using m3x3 = DirectX::XMFLOAT3X3; // NOTE: DirectXMath doesn't have aligned 3x3 matrices
 	using m4x4 = DirectX::XMFLOAT4X4;
 	using m4x4a = DirectX::XMFLOAT4X4A;
-#endif
 }
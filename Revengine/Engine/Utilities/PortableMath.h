@@ -0,0 +1,223 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// DirectXMath only comes with Windows, so builds for other platforms use this instead. It has the same names and
+// layouts as the part of DirectXMath that the engine uses, so code written against DirectXMath compiles unchanged.
+// Vectors are four plain floats and every function works one lane at a time, which leaves the vectorizing to the compiler
+namespace DirectX {
+	struct XMFLOAT2 {
+		float x;
+		float y;
+
+		XMFLOAT2() = default;
+		constexpr XMFLOAT2(float _x, float _y) : x{ _x }, y{ _y } {}
+		explicit XMFLOAT2(const float* array) : x{ array[0] }, y{ array[1] } {}
+	};
+
+	struct alignas(16) XMFLOAT2A : public XMFLOAT2 {
+		using XMFLOAT2::XMFLOAT2;
+		XMFLOAT2A() = default;
+	};
+
+	struct XMFLOAT3 {
+		float x;
+		float y;
+		float z;
+
+		XMFLOAT3() = default;
+		constexpr XMFLOAT3(float _x, float _y, float _z) : x{ _x }, y{ _y }, z{ _z } {}
+		explicit XMFLOAT3(const float* array) : x{ array[0] }, y{ array[1] }, z{ array[2] } {}
+	};
+
+	struct alignas(16) XMFLOAT3A : public XMFLOAT3 {
+		using XMFLOAT3::XMFLOAT3;
+		XMFLOAT3A() = default;
+	};
+
+	struct XMFLOAT4 {
+		float x;
+		float y;
+		float z;
+		float w;
+
+		XMFLOAT4() = default;
+		constexpr XMFLOAT4(float _x, float _y, float _z, float _w) : x{ _x }, y{ _y }, z{ _z }, w{ _w } {}
+		explicit XMFLOAT4(const float* array) : x{ array[0] }, y{ array[1] }, z{ array[2] }, w{ array[3] } {}
+	};
+
+	struct alignas(16) XMFLOAT4A : public XMFLOAT4 {
+		using XMFLOAT4::XMFLOAT4;
+		XMFLOAT4A() = default;
+	};
+
+	struct XMINT2 { int32_t x; int32_t y; };
+	struct XMINT3 { int32_t x; int32_t y; int32_t z; };
+	struct XMINT4 { int32_t x; int32_t y; int32_t z; int32_t w; };
+	struct XMUINT2 { uint32_t x; uint32_t y; };
+	struct XMUINT3 { uint32_t x; uint32_t y; uint32_t z; };
+	struct XMUINT4 { uint32_t x; uint32_t y; uint32_t z; uint32_t w; };
+
+	struct XMFLOAT3X3 { float m[3][3]; };
+	struct XMFLOAT4X4 { float m[4][4]; };
+	struct alignas(16) XMFLOAT4X4A : public XMFLOAT4X4 {};
+
+	struct alignas(16) XMVECTOR {
+		float f[4];
+	};
+
+	namespace detail {
+		template<typename function>
+		inline XMVECTOR per_lane(XMVECTOR v, function f) {
+			return { { f(v.f[0]), f(v.f[1]), f(v.f[2]), f(v.f[3]) } };
+		}
+
+		template<typename function>
+		inline XMVECTOR per_lane(XMVECTOR a, XMVECTOR b, function f) {
+			return { { f(a.f[0], b.f[0]), f(a.f[1], b.f[1]), f(a.f[2], b.f[2]), f(a.f[3], b.f[3]) } };
+		}
+
+		// Comparisons give lanes with every bit set, like they do in SIMD registers
+		inline float mask(bool set) {
+			const uint32_t bits{ set ? 0xffffffffu : 0u };
+			float lane;
+			memcpy(&lane, &bits, sizeof(float));
+			return lane;
+		}
+	}
+
+	inline XMVECTOR XMVectorZero() { return { { 0.f, 0.f, 0.f, 0.f } }; }
+	inline XMVECTOR XMVectorSet(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+	inline XMVECTOR XMVectorReplicate(float value) { return { { value, value, value, value } }; }
+	inline XMVECTOR XMLoadFloat4A(const XMFLOAT4A* source) { return { { source->x, source->y, source->z, source->w } }; }
+
+	inline void XMStoreFloat4A(XMFLOAT4A* destination, XMVECTOR v) {
+		*destination = { v.f[0], v.f[1], v.f[2], v.f[3] };
+	}
+
+	inline XMVECTOR XMVectorSubtract(XMVECTOR a, XMVECTOR b) { return detail::per_lane(a, b, [](float x, float y) { return x - y; }); }
+	inline XMVECTOR XMVectorMultiply(XMVECTOR a, XMVECTOR b) { return detail::per_lane(a, b, [](float x, float y) { return x * y; }); }
+	inline XMVECTOR XMVectorDivide(XMVECTOR a, XMVECTOR b) { return detail::per_lane(a, b, [](float x, float y) { return x / y; }); }
+	inline XMVECTOR XMVectorMin(XMVECTOR a, XMVECTOR b) { return detail::per_lane(a, b, [](float x, float y) { return x < y ? x : y; }); }
+	inline XMVECTOR XMVectorMax(XMVECTOR a, XMVECTOR b) { return detail::per_lane(a, b, [](float x, float y) { return x > y ? x : y; }); }
+	inline XMVECTOR XMVectorLess(XMVECTOR a, XMVECTOR b) { return detail::per_lane(a, b, [](float x, float y) { return detail::mask(x < y); }); }
+	inline XMVECTOR XMVectorEqual(XMVECTOR a, XMVECTOR b) { return detail::per_lane(a, b, [](float x, float y) { return detail::mask(x == y); }); }
+
+	// a * b + c
+	inline XMVECTOR XMVectorMultiplyAdd(XMVECTOR a, XMVECTOR b, XMVECTOR c) {
+		return { { a.f[0] * b.f[0] + c.f[0], a.f[1] * b.f[1] + c.f[1], a.f[2] * b.f[2] + c.f[2], a.f[3] * b.f[3] + c.f[3] } };
+	}
+
+	// The lanes of b where the control lane has its bits set, and the lanes of a everywhere else
+	inline XMVECTOR XMVectorSelect(XMVECTOR a, XMVECTOR b, XMVECTOR control) {
+		uint32_t lanes_a[4], lanes_b[4], lanes_control[4];
+		memcpy(lanes_a, a.f, sizeof(lanes_a));
+		memcpy(lanes_b, b.f, sizeof(lanes_b));
+		memcpy(lanes_control, control.f, sizeof(lanes_control));
+		for (uint32_t i{ 0 }; i < 4; i++) lanes_a[i] = (lanes_a[i] & ~lanes_control[i]) | (lanes_b[i] & lanes_control[i]);
+
+		XMVECTOR result;
+		memcpy(result.f, lanes_a, sizeof(lanes_a));
+		return result;
+	}
+
+	inline XMVECTOR XMVectorNegate(XMVECTOR v) { return detail::per_lane(v, [](float x) { return -x; }); }
+	inline XMVECTOR XMVectorAbs(XMVECTOR v) { return detail::per_lane(v, [](float x) { return std::fabs(x); }); }
+	inline XMVECTOR XMVectorSqrt(XMVECTOR v) { return detail::per_lane(v, [](float x) { return std::sqrt(x); }); }
+	inline XMVECTOR XMVectorReciprocalSqrt(XMVECTOR v) { return detail::per_lane(v, [](float x) { return 1.f / std::sqrt(x); }); }
+	inline XMVECTOR XMVectorSin(XMVECTOR v) { return detail::per_lane(v, [](float x) { return std::sin(x); }); }
+	inline XMVECTOR XMVectorACos(XMVECTOR v) { return detail::per_lane(v, [](float x) { return std::acos(x); }); }
+
+	inline void XMVectorSinCos(XMVECTOR* sin, XMVECTOR* cos, XMVECTOR v) {
+		*sin = detail::per_lane(v, [](float x) { return std::sin(x); });
+		*cos = detail::per_lane(v, [](float x) { return std::cos(x); });
+	}
+
+	namespace PackedVector {
+		using HALF = uint16_t;
+
+		// Rounds to the nearest half, and to the even one on a tie, like the F16C instructions do
+		inline HALF XMConvertFloatToHalf(float value) {
+			uint32_t bits;
+			memcpy(&bits, &value, sizeof(float));
+			const uint32_t sign{ (bits >> 16) & 0x8000u };
+			const uint32_t stored_exponent{ (bits >> 23) & 0xffu };
+			uint32_t mantissa{ bits & 0x7fffffu };
+
+			// Infinities stay infinite, and NaNs stay NaNs
+			if (stored_exponent == 0xffu) return (HALF)(sign | 0x7c00u | (mantissa ? 0x200u : 0u));
+
+			const int32_t exponent{ (int32_t)stored_exponent - 127 + 15 };
+			if (exponent >= 31) return (HALF)(sign | 0x7c00u);
+
+			// Too small for a normal half, so it becomes a subnormal one, or zero
+			uint32_t shift{ 13 };
+			uint32_t half{ sign | ((uint32_t)exponent << 10) };
+			if (exponent <= 0) {
+				if (exponent < -10) return (HALF)sign;
+				mantissa |= 0x800000u;
+				shift = (uint32_t)(14 - exponent);
+				half = sign;
+			}
+
+			// A carry out of the mantissa moves on into the exponent, which is where it belongs
+			const uint32_t rest{ mantissa & ((1u << shift) - 1) };
+			const uint32_t halfway{ 1u << (shift - 1) };
+			half += mantissa >> shift;
+			if (rest > halfway || (rest == halfway && (half & 1))) ++half;
+			return (HALF)half;
+		}
+
+		inline float XMConvertHalfToFloat(HALF value) {
+			const uint32_t sign{ (uint32_t)(value & 0x8000u) << 16 };
+			uint32_t exponent{ (uint32_t)(value >> 10) & 0x1fu };
+			uint32_t mantissa{ (uint32_t)value & 0x3ffu };
+			uint32_t bits;
+
+			if (exponent == 0x1fu) {
+				bits = sign | 0x7f800000u | (mantissa << 13);
+			}
+			else if (exponent) {
+				bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+			}
+			else if (!mantissa) {
+				bits = sign;
+			}
+			else {
+				// Subnormal halves are normal floats
+				exponent = 113;
+				while (!(mantissa & 0x400u)) {
+					mantissa <<= 1;
+					--exponent;
+				}
+
+				bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+			}
+
+			float result;
+			memcpy(&result, &bits, sizeof(float));
+			return result;
+		}
+
+		// Strides are in bytes
+		inline HALF* XMConvertFloatToHalfStream(HALF* output, size_t output_stride, const float* input, size_t input_stride, size_t count) {
+			for (size_t i{ 0 }; i < count; i++) {
+				const float* const from{ (const float*)((const uint8_t*)input + i * input_stride) };
+				*(HALF*)((uint8_t*)output + i * output_stride) = XMConvertFloatToHalf(*from);
+			}
+
+			return output;
+		}
+
+		inline float* XMConvertHalfToFloatStream(float* output, size_t output_stride, const HALF* input, size_t input_stride, size_t count) {
+			for (size_t i{ 0 }; i < count; i++) {
+				const HALF* const from{ (const HALF*)((const uint8_t*)input + i * input_stride) };
+				*(float*)((uint8_t*)output + i * output_stride) = XMConvertHalfToFloat(*from);
+			}
+
+			return output;
+		}
+	}
+}
\ No newline at end of file
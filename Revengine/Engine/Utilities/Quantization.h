@@ -0,0 +1,91 @@
+#pragma once
+#include "../Common/CommonHeaders.h"
+#include <cmath>
+
+namespace revengine::utl {
+	/// <summary>
+	/// Get the amount of bits needed to store every value from 0 to max_value
+	/// </summary>
+	constexpr u32 bits_for_value(u64 max_value) {
+		u32 bits{ 0 };
+		while (max_value) {
+			max_value >>= 1;
+			++bits;
+		}
+		return bits;
+	}
+
+	/// <summary>
+	/// Map a value to an integer amount of steps from -half_steps * precision, clamping values outside of the range.
+	/// Values are quantized relative to 0 so that large values don't lose float precision on the way back
+	/// </summary>
+	/// <param name="value">The value to quantize</param>
+	/// <param name="precision">The size of one step</param>
+	/// <param name="half_steps">The amount of steps on each side of 0</param>
+	/// <returns>A value from 0 to 2 * half_steps</returns>
+	inline u32 quantize_signed(f32 value, f32 precision, u32 half_steps) {
+		const f32 step{ std::round(value / precision) };
+		if (!(step > -(f32)half_steps)) return 0; // Also catches NaN
+		return step >= (f32)half_steps ? 2 * half_steps : (u32)((s32)step + (s32)half_steps);
+	}
+
+	inline f32 dequantize_signed(u32 step, f32 precision, u32 half_steps) {
+		return (f32)((s32)step - (s32)half_steps) * precision;
+	}
+
+	// Quaternions are compressed with the smallest-three method: since the quaternion has unit length, its largest
+	// component can be rebuilt from the other three, which in turn can't be larger than 1/sqrt(2). The packed value
+	// holds the index of the dropped component in its top 2 bits and the other three components below that.
+	// q and -q are the same rotation, so the quaternion is flipped to make the dropped component positive.
+	constexpr u32 max_smallest_three_bits{ 10 };
+
+	/// <summary>
+	/// Pack a unit quaternion (x, y, z, w) into 2 + 3 * bits bits
+	/// </summary>
+	/// <param name="q">The quaternion to pack</param>
+	/// <param name="bits">The amount of bits for each of the three stored components</param>
+	inline u32 pack_smallest_three(const f32* q, u32 bits) {
+		assert(bits >= 2 && bits <= max_smallest_three_bits);
+		constexpr f32 max_component{ 0.70710678118f };
+
+		// Find the largest component
+		u32 largest{ 0 };
+		for (u32 i{ 1 }; i < 4; i++) {
+			if (std::abs(q[i]) > std::abs(q[largest])) largest = i;
+		}
+
+		const f32 sign{ q[largest] < 0.f ? -1.f : 1.f };
+		const u32 half_steps{ (1u << (bits - 1)) - 1 };
+		const f32 precision{ max_component / (f32)half_steps };
+
+		// Store the other three in order
+		u32 packed{ largest };
+		for (u32 i{ 0 }; i < 4; i++) {
+			if (i == largest) continue;
+			packed = (packed << bits) | quantize_signed(q[i] * sign, precision, half_steps);
+		}
+
+		return packed;
+	}
+
+	inline void unpack_smallest_three(u32 packed, u32 bits, f32* q) {
+		assert(bits >= 2 && bits <= max_smallest_three_bits);
+		constexpr f32 max_component{ 0.70710678118f };
+		const u32 mask{ (1u << bits) - 1 };
+		const u32 half_steps{ (1u << (bits - 1)) - 1 };
+		const f32 precision{ max_component / (f32)half_steps };
+		const u32 largest{ (packed >> (3 * bits)) & 3 };
+
+		// Read the three stored components back, last one first
+		f32 sum{ 0.f };
+		for (u32 i{ 4 }; i-- > 0;) {
+			if (i == largest) continue;
+			q[i] = dequantize_signed(packed & mask, precision, half_steps);
+			sum += q[i] * q[i];
+			packed >>= bits;
+		}
+
+		// Rebuild the largest component from the unit length
+		q[largest] = std::sqrt(std::max(0.f, 1.f - sum));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+#pragma once
+#include "../Common/CommonHeaders.h"
+#include <atomic>
+#include <cstring>
+
+namespace revengine::utl {
+	// A set of single-producer/single-consumer ring buffers, one per producing thread, that one consumer drains. Each
+	// thread gets its queue the first time it writes, without taking a lock. When a thread exits, its queue is released,
+	// and once the consumer has drained it, it can be claimed by a new thread. The tag keeps sets with the same sizes apart,
+	// as every set needs its own thread-local queue
+	template<typename tag, u32 capacity, u32 alignment = 16>
+	class thread_queues {
+	public:
+		// Every record is a prefix followed by the caller's bytes, padded to the alignment. Because the capacity is a
+		// multiple of the alignment, there is always room for at least a prefix before the wrap point
+		struct record_prefix {
+			u32 size; // The size of the caller's bytes, or invalid_id for padding at the end of the buffer
+			u32 record_size; // The size of the whole record, including the prefix and padding
+		};
+
+		static_assert(sizeof(record_prefix) <= alignment && (alignment & (alignment - 1)) == 0);
+		static_assert(capacity % alignment == 0);
+
+		thread_queues() = default;
+		~thread_queues() { reset(); }
+		thread_queues(const thread_queues&) = delete;
+		thread_queues& operator=(const thread_queues&) = delete;
+
+		/// <summary>
+		/// Reserve space for a record in the calling thread's queue. Records only become visible to the consumer once
+		/// end_record() is called, and a thread can only have one record open at a time
+		/// </summary>
+		/// <param name="size">The amount of bytes the caller writes</param>
+		/// <returns>Where to write the bytes to, or nullptr if the consumer hasn't freed enough space yet. The record is
+		/// counted as dropped then</returns>
+		u8* begin_record(u32 size) {
+			queue& q{ local_queue() };
+			const u32 record_size{ align_record(sizeof(record_prefix) + size) };
+
+			u64 tail{ q.tail.load(std::memory_order_relaxed) };
+			const u64 head{ q.head.load(std::memory_order_acquire) };
+			const u32 offset{ (u32)(tail % capacity) };
+			const u32 contiguous{ capacity - offset };
+
+			// If the record doesn't fit before the end of the buffer, it has to start back at the beginning
+			const u32 wrap{ contiguous < record_size ? contiguous : 0 };
+
+			// Check if the consumer has freed enough space. Producers must never wait for the consumer
+			if (record_size > capacity || tail + wrap + record_size - head > capacity) {
+				q.dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			if (wrap) {
+				// Fill the rest of the buffer with a padding record
+				const record_prefix padding{ u32_invalid_id, wrap };
+				memcpy(&q.buffer[offset], &padding, sizeof(record_prefix));
+				tail += wrap;
+			}
+
+			u8* const record{ &q.buffer[tail % capacity] };
+			const record_prefix prefix{ size, record_size };
+			memcpy(record, &prefix, sizeof(record_prefix));
+			q.record_end = tail + record_size;
+
+			return record + sizeof(record_prefix);
+		}
+
+		/// <summary>
+		/// Publish the record that was started last by this thread to the consumer
+		/// </summary>
+		void end_record() {
+			queue& q{ *_local.owned };
+			q.tail.store(q.record_end, std::memory_order_release);
+		}
+
+		/// <summary>
+		/// Take every published record out of the queues, in order per queue. Only one thread may call this at a time
+		/// </summary>
+		/// <param name="callback">Called with the bytes and the size of each record</param>
+		/// <returns>The amount of records that were dropped since the last drain</returns>
+		template<typename callback_type>
+		u32 drain(callback_type&& callback) {
+			u32 dropped{ 0 };
+
+			for (queue* q{ _queues.load(std::memory_order_acquire) }; q; q = q->next) {
+				// Check if the owner of the queue has exited before draining it, so that no records are left behind
+				const bool was_released{ q->state.load(std::memory_order_acquire) == released };
+
+				u64 head{ q->head.load(std::memory_order_relaxed) };
+				const u64 tail{ q->tail.load(std::memory_order_acquire) };
+
+				while (head < tail) {
+					const u8* const record{ &q->buffer[head % capacity] };
+					record_prefix prefix;
+					memcpy(&prefix, record, sizeof(record_prefix));
+					assert(prefix.record_size && prefix.record_size % alignment == 0);
+
+					// Padding records only mark that the producer wrapped around to the start of the buffer
+					if (prefix.size != u32_invalid_id) callback(record + sizeof(record_prefix), prefix.size);
+					head += prefix.record_size;
+				}
+
+				// Hand the consumed space back to the producer
+				q->head.store(head, std::memory_order_release);
+				dropped += q->dropped.exchange(0, std::memory_order_relaxed);
+				if (was_released) q->state.store(available, std::memory_order_release);
+			}
+
+			return dropped;
+		}
+
+		/// <summary>
+		/// Free every queue, and make every thread get a new one the next time it writes. No other thread may write while
+		/// this runs
+		/// </summary>
+		void reset() {
+			_epoch.fetch_add(1, std::memory_order_acq_rel);
+
+			queue* q{ _queues.exchange(nullptr, std::memory_order_acq_rel) };
+			while (q) {
+				queue* const next{ q->next };
+				delete q;
+				q = next;
+			}
+
+			_local = {};
+		}
+
+	private:
+		enum queue_state : u8 {
+			in_use,
+			released,
+			available,
+		};
+
+		// Positions only ever increase and are wrapped when indexing the buffer
+		struct queue {
+			alignas(64) std::atomic<u64> head{ 0 };
+			alignas(64) std::atomic<u64> tail{ 0 };
+			u64 record_end{ 0 }; // The tail after the record that is being written, only used by the producer
+			std::atomic<u32> dropped{ 0 };
+			queue* next{ nullptr };
+			std::atomic<u8> state{ in_use };
+			alignas(alignment) u8 buffer[capacity];
+		};
+
+		struct queue_owner {
+			queue* owned{ nullptr };
+			thread_queues* set{ nullptr };
+			u32 epoch{ u32_invalid_id };
+
+			~queue_owner() {
+				if (owned && epoch == set->_epoch.load(std::memory_order_acquire)) {
+					owned->state.store(released, std::memory_order_release);
+				}
+			}
+		};
+
+		// Queues are pushed onto a lock-free list, and live until reset()
+		std::atomic<queue*> _queues{ nullptr };
+		std::atomic<u32> _epoch{ 0 };
+		inline static thread_local queue_owner _local;
+
+		static constexpr u32 align_record(u32 size) {
+			return (size + alignment - 1) & ~(alignment - 1);
+		}
+
+		queue& local_queue() {
+			const u32 epoch{ _epoch.load(std::memory_order_acquire) };
+
+			// Check if this thread already has a queue, and that the set wasn't reset since
+			if (_local.owned && _local.set == this && _local.epoch == epoch) return *_local.owned;
+
+			queue* q{ nullptr };
+
+			// Try to claim a queue that was left behind by a thread that exited
+			for (queue* it{ _queues.load(std::memory_order_acquire) }; it; it = it->next) {
+				u8 expected{ available };
+				if (it->state.compare_exchange_strong(expected, in_use, std::memory_order_acq_rel)) {
+					q = it;
+					break;
+				}
+			}
+
+			if (!q) {
+				q = new queue{};
+				q->next = _queues.load(std::memory_order_relaxed);
+
+				// Push the queue onto the front of the list
+				while (!_queues.compare_exchange_weak(q->next, q, std::memory_order_release, std::memory_order_relaxed)) {}
+			}
+
+			_local.owned = q;
+			_local.set = this;
+			_local.epoch = epoch;
+			return *q;
+		}
+	};
+}
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "Common.h"
 #include "CommonHeaders.h"
-#include "..\Engine\Components\Script.h"
+#include "../Engine/Components/Script.h"
+#include "../Engine/Platform/Module.h"
+#include "../Engine/Core/ChangeJournal.h"
 
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
@@ -12,28 +14,94 @@
 using namespace revengine;
 
 namespace {
-	HMODULE game_code_dll{ nullptr };
+	platform::module_handle game_code_dll{ nullptr };
 	using _get_script_creator = revengine::script::detail::script_creator(*)(size_t);
 	_get_script_creator get_script_creator{ nullptr };
 	using _get_script_names = LPSAFEARRAY(*)(void);
 	_get_script_names get_script_names{ nullptr };
+
+	// The registry tag of every creator handed out to the editor, so that scripts can be rebound after a reload
+	std::unordered_map<script::detail::script_creator, size_t> creator_tags;
+	u32 reload_count{ 0 };
+	std::string game_code_copy; // The path of the copy that game_code_dll was loaded from
+
+	struct reload_info {
+		const char* dll_path;
+		platform::module_handle old_dll;
+	};
+
+	bool bind_game_code(platform::module_handle dll) {
+		// Get a pointer to get_script_creator
+		get_script_creator = (_get_script_creator)platform::get_symbol(dll, "get_script_creator");
+
+		// Get a pointer to get_script_names
+		get_script_names = (_get_script_names)platform::get_symbol(dll, "get_script_names");
+
+		return get_script_creator && get_script_names;
+	}
+
+	bool unload_game_code(platform::module_handle dll) {
+		const bool result{ platform::unload_module_copy(dll, game_code_copy.c_str()) };
+		game_code_copy.clear();
+		return result;
+	}
+
+	// The game code is always loaded from a copy, so that the DLL itself is never locked and the build can replace it
+	std::string next_copy_path(const char* dll_path) {
+		return std::string{ dll_path } + ".reload" + std::to_string(reload_count++);
+	}
+
+	bool swap_game_code(void* user_data) {
+		reload_info& info{ *(reload_info*)user_data };
+
+		const std::string copy_path{ next_copy_path(info.dll_path) };
+		platform::module_handle new_dll{ platform::load_module_copy(info.dll_path, copy_path.c_str()) };
+
+		// Keep the old DLL loaded if the new one can't be used, so the scripts can be recreated from it
+		if (!new_dll || !bind_game_code(new_dll)) {
+			if (new_dll) platform::unload_module_copy(new_dll, copy_path.c_str());
+			bind_game_code(info.old_dll);
+			return false;
+		}
+
+		// The old code isn't referenced by any script anymore, so it can be unloaded, along with its copy
+		const bool result{ unload_game_code(info.old_dll) };
+		assert(result);
+		game_code_dll = new_dll;
+		game_code_copy = copy_path;
+		return true;
+	}
+
+	script::detail::script_creator rebind_script_creator(script::detail::script_creator old_creator, void*) {
+		// Find the tag the creator was registered with and look it up in the new DLL
+		const auto tag{ creator_tags.find(old_creator) };
+		if (tag == creator_tags.end()) return nullptr;
+
+		script::detail::script_creator new_creator{ get_script_creator(tag->second) };
+		if (new_creator) creator_tags[new_creator] = tag->second;
+		return new_creator;
+	}
 }
 
 EDITOR_INTERFACE u32 LoadGameCodeDLL(const char* dll_path) {
 	// Check that the game_code_dll exists
 	if (game_code_dll) return FALSE;
 
-	// Load the library and assert
-	game_code_dll = LoadLibraryA(dll_path);
+	// Load a copy of the library and assert, so that ReloadGameCodeDLL() can pick up a new build of it
+	const std::string copy_path{ next_copy_path(dll_path) };
+	game_code_dll = platform::load_module_copy(dll_path, copy_path.c_str());
 	assert(game_code_dll);
+	if (!game_code_dll) return FALSE;
 
-	// Get a pointer to get_script_creator
-	get_script_creator = (_get_script_creator)GetProcAddress(game_code_dll, "get_script_creator");
+	// Don't hold on to a DLL that isn't game code
+	game_code_copy = copy_path;
+	if (!bind_game_code(game_code_dll)) {
+		unload_game_code(game_code_dll);
+		game_code_dll = nullptr;
+		return FALSE;
+	}
 
-	// Get a pointer to get_script_names
-	get_script_names = (_get_script_names)GetProcAddress(game_code_dll, "get_script_names");
-	
-	return (game_code_dll && get_script_creator && get_script_names) ? TRUE : FALSE;
+	return TRUE;
 }
 
 EDITOR_INTERFACE u32 UnloadGameCodeDLL() {
@@ -42,20 +110,59 @@ EDITOR_INTERFACE u32 UnloadGameCodeDLL() {
 	assert(game_code_dll);
 
 	// Free the library and assert the result
-	int result{ FreeLibrary(game_code_dll) };
+	const bool result{ unload_game_code(game_code_dll) };
 	assert(result);
 
 	// Set to nullptr for memory
 	game_code_dll = nullptr;
+	creator_tags.clear();
 
 	return TRUE;
 }
 
+EDITOR_INTERFACE u32 ReloadGameCodeDLL(const char* dll_path) {
+	// Reloading needs game code that is already loaded, otherwise it's just a load
+	if (!game_code_dll) return LoadGameCodeDLL(dll_path);
+
+	// Serialize, destroy, swap, rebind and recreate every live script
+	reload_info info{ dll_path, game_code_dll };
+	script::hot_reload(&swap_game_code, &rebind_script_creator, &info);
+
+	// Creators from the old DLL point into unloaded code now
+	if (game_code_dll != info.old_dll) {
+		for (auto it{ creator_tags.begin() }; it != creator_tags.end();) {
+			if (get_script_creator(it->second) != it->first) it = creator_tags.erase(it);
+			else ++it;
+		}
+	}
+
+	return game_code_dll != info.old_dll ? TRUE : FALSE;
+}
+
 EDITOR_INTERFACE script::detail::script_creator GetScriptCreator(const char* name) {
 	// If we have a valid pointer and a valid game code DLL, get the tag and the pointer to the creation function for the string
-	return (game_code_dll && get_script_creator) ? get_script_creator(script::detail::string_hash()(name)) : nullptr;
+	if (!game_code_dll || !get_script_creator) return nullptr;
+
+	// Remember the tag of the creator, so that it can be found again in a reloaded DLL
+	const size_t tag{ script::detail::string_hash()(name) };
+	script::detail::script_creator creator{ get_script_creator(tag) };
+	if (creator) creator_tags[creator] = tag;
+	return creator;
 }
 
 EDITOR_INTERFACE LPSAFEARRAY GetScriptNames() {
 	return (game_code_dll && get_script_names) ? get_script_names() : nullptr;
+}
+
+EDITOR_INTERFACE u32 StartChangeJournal(const char* name, u32 capacity) {
+	// The editor opens the shared memory by the same name and reads the changes from there
+	return journal::initialize(name, capacity) ? TRUE : FALSE;
+}
+
+EDITOR_INTERFACE u32 RecordChanges() {
+	return journal::record();
+}
+
+EDITOR_INTERFACE void StopChangeJournal() {
+	journal::shutdown();
 }
\ No newline at end of file
@@ -1,8 +1,8 @@
 #include "CommonHeaders.h"
 #include "Id.h"
-#include "..\Engine\Components\Grievance.h"
-#include "..\Engine\Components\Transform.h"
-#include "..\Engine\Components\Script.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
+#include "../Engine/Components/Script.h"
 #include "Common.h"
 
 using namespace revengine;
@@ -48,6 +48,65 @@ namespace {
 		script_motivator script;
 	};
 
+	// The amount of descriptors converted at once when creating grievances in bulk - small enough to keep
+	// the converted init_infos on the stack
+	constexpr u32 batch_size{ 64 };
+
+	/// <summary>
+	/// Convert a batch of descriptors to transform init_infos. Instead of converting each Euler rotation on its own,
+	/// this converts the rotations of four descriptors at once, with each SIMD lane holding one descriptor
+	/// </summary>
+	/// <param name="descriptors">The descriptors to convert</param>
+	/// <param name="infos">The init_infos to write to</param>
+	/// <param name="count">The amount of descriptors to convert</param>
+	void to_init_infos(grievance_descriptor* descriptors, transform::init_info* infos, u32 count) {
+		using namespace DirectX;
+		const XMVECTOR one_half{ XMVectorReplicate(0.5f) };
+		u32 i{ 0 };
+
+		for (; i + 4 <= count; i += 4) {
+			const transform_motivator& t0{ descriptors[i].transform };
+			const transform_motivator& t1{ descriptors[i + 1].transform };
+			const transform_motivator& t2{ descriptors[i + 2].transform };
+			const transform_motivator& t3{ descriptors[i + 3].transform };
+
+			// Transpose the pitch, yaw and roll of the four rotations into their own vectors
+			XMVECTOR sp, cp, sy, cy, sr, cr;
+			XMVectorSinCos(&sp, &cp, XMVectorMultiply(XMVectorSet(t0.rotation[0], t1.rotation[0], t2.rotation[0], t3.rotation[0]), one_half));
+			XMVectorSinCos(&sy, &cy, XMVectorMultiply(XMVectorSet(t0.rotation[1], t1.rotation[1], t2.rotation[1], t3.rotation[1]), one_half));
+			XMVectorSinCos(&sr, &cr, XMVectorMultiply(XMVectorSet(t0.rotation[2], t1.rotation[2], t2.rotation[2], t3.rotation[2]), one_half));
+
+			// Same math as XMQuaternionRotationRollPitchYawFromVector, one component at a time
+			const XMVECTOR cp_cy{ XMVectorMultiply(cp, cy) };
+			const XMVECTOR sp_sy{ XMVectorMultiply(sp, sy) };
+			const XMVECTOR sp_cy{ XMVectorMultiply(sp, cy) };
+			const XMVECTOR cp_sy{ XMVectorMultiply(cp, sy) };
+			XMFLOAT4A x, y, z, w;
+			XMStoreFloat4A(&x, XMVectorMultiplyAdd(cp_sy, sr, XMVectorMultiply(sp_cy, cr)));
+			XMStoreFloat4A(&y, XMVectorNegativeMultiplySubtract(sp_cy, sr, XMVectorMultiply(cp_sy, cr)));
+			XMStoreFloat4A(&z, XMVectorNegativeMultiplySubtract(sp_sy, cr, XMVectorMultiply(cp_cy, sr)));
+			XMStoreFloat4A(&w, XMVectorMultiplyAdd(sp_sy, sr, XMVectorMultiply(cp_cy, cr)));
+
+			const f32* const components[4]{ &x.x, &y.x, &z.x, &w.x };
+			for (u32 lane{ 0 }; lane < 4; lane++) {
+				transform::init_info& info{ infos[i + lane] };
+				const transform_motivator& t{ descriptors[i + lane].transform };
+
+				// Copy over position and scale
+				memcpy(&info.position[0], &t.position[0], sizeof(f32) * _countof(t.position));
+				memcpy(&info.scale[0], &t.scale[0], sizeof(f32) * _countof(t.scale));
+
+				// Write back this lane of the quaternions
+				for (u32 c{ 0 }; c < 4; c++) info.rotation[c] = components[c][lane];
+			}
+		}
+
+		// Convert the remaining descriptors one at a time
+		for (; i < count; i++) {
+			infos[i] = descriptors[i].transform.to_init_info();
+		}
+	}
+
 	grievance::grievance grievance_from_id(id::id_type id) {
 		// Put the ID into a grievance_id and return a grievance from that
 		// grievance_id
@@ -83,4 +142,49 @@ void RemoveGrievance(id::id_type id) {
 
 	// Remove the grievancw attached to the ID
 	grievance::remove(grievance::grievance_id{ id });
+}
+
+EDITOR_INTERFACE
+u32 CreateGrievances(grievance_descriptor* descriptors, u32 count, id::id_type* ids) {
+	// Confirm the descriptors and the ID array are valid
+	assert(descriptors && ids);
+	u32 created{ 0 };
+
+	for (u32 first{ 0 }; first < count; first += batch_size) {
+		const u32 size{ std::min(batch_size, count - first) };
+
+		// Convert the transforms of the whole batch at once
+		transform::init_info transform_infos[batch_size];
+		to_init_infos(&descriptors[first], &transform_infos[0], size);
+
+		for (u32 i{ 0 }; i < size; i++) {
+			script::init_info script_info{ descriptors[first + i].script.to_init_info() };
+			grievance::grievance_info grievance_info{
+				&transform_infos[i],
+				&script_info
+			};
+
+			// Write the ID given by the newly created grievance back to the editor
+			const id::id_type id{ grievance::create(grievance_info).get_id() };
+			ids[first + i] = id;
+			if (id::is_valid(id)) ++created;
+		}
+	}
+
+	// Return the amount of grievances that were created
+	return created;
+}
+
+EDITOR_INTERFACE
+void RemoveGrievances(const id::id_type* ids, u32 count) {
+	// Confirm the ID array is valid
+	assert(ids);
+
+	for (u32 i{ 0 }; i < count; i++) {
+		// Confirm that the ID is valid
+		assert(id::is_valid(ids[i]));
+
+		// Remove the grievance attached to the ID
+		grievance::remove(grievance::grievance_id{ ids[i] });
+	}
 }
\ No newline at end of file
@@ -103,6 +103,31 @@ namespace RevengineEditor.Components
             OnDeserialized(new StreamingContext());
         }
 
+        /// <summary>
+        /// Mark the Grievance as active with an ID that was already created in the engine, such as
+        /// when a whole Scene is created in one batch
+        /// </summary>
+        /// <param name="id">The engine ID of the Grievance</param>
+        public void Activate(int id)
+        {
+            Debug.Assert(!_isActive && ID.Isvalid(id));
+            _isActive = true;
+            GrievanceID = id;
+            OnPropertyChanged(nameof(IsActive));
+        }
+
+        /// <summary>
+        /// Mark the Grievance as inactive after it was already removed from the engine, such as
+        /// when many Grievances are removed in one batch
+        /// </summary>
+        public void Deactivate()
+        {
+            Debug.Assert(_isActive);
+            _isActive = false;
+            GrievanceID = ID.INVALID_ID;
+            OnPropertyChanged(nameof(IsActive));
+        }
+
         /// <summary>
         /// Add a Motivator to the Grievance
         /// </summary>
@@ -14,25 +14,27 @@ using System.Threading.Tasks;
 // in the C++ engine
 namespace RevengineEditor.EngineAPIStructs
 {
+    // These are blittable structs, so arrays of them are pinned and handed to the engine as they are instead of
+    // being copied element by element
     [StructLayout(LayoutKind.Sequential)]
-    class TransformMotivator
+    struct TransformMotivator
     {
         public Vector3 Position;
         public Vector3 Rotation;
-        public Vector3 Scale = new Vector3(1, 1, 1);
+        public Vector3 Scale;
     }
 
     [StructLayout(LayoutKind.Sequential)]
-    class ScriptMotivator
+    struct ScriptMotivator
     {
         public IntPtr ScriptCreator;
     }
 
     [StructLayout(LayoutKind.Sequential)]
-    class GameGrievanceDescriptor
+    struct GameGrievanceDescriptor
     {
-        public TransformMotivator Transform = new TransformMotivator();
-        public ScriptMotivator Script = new ScriptMotivator();
+        public TransformMotivator Transform;
+        public ScriptMotivator Script;
     }
 }
 
@@ -49,6 +51,9 @@ namespace RevengineEditor.DLLWrappers
         [DllImport(_engineDLL)]
         public static extern int UnloadGameCodeDLL();
 
+        [DllImport(_engineDLL, CharSet = CharSet.Ansi)]
+        public static extern int ReloadGameCodeDLL(string dllPath);
+
         [DllImport(_engineDLL)]
         public static extern IntPtr GetScriptCreator(string name);
 
@@ -56,14 +61,29 @@ namespace RevengineEditor.DLLWrappers
         [return: MarshalAs(UnmanagedType.SafeArray)]
         public static extern string[] GetScriptNames();
 
+        // The engine writes the transforms that changed each frame into shared memory with this name
+        [DllImport(_engineDLL, CharSet = CharSet.Ansi)]
+        public static extern int StartChangeJournal(string name, uint capacity);
+
+        [DllImport(_engineDLL)]
+        public static extern uint RecordChanges();
+
+        [DllImport(_engineDLL)]
+        public static extern void StopChangeJournal();
+
         internal static class GrievanceAPI
         {
-            // Import functions
-            [DllImport(_engineDLL)]
-            private static extern int CreateGrievance(GameGrievanceDescriptor desc);
-            public static int CreateGrievance(Grievance grievance)
+            // Reused between calls to CreateGrievances, and only grown when a bigger batch comes along
+            private static GameGrievanceDescriptor[] _descriptors = new GameGrievanceDescriptor[0];
+
+            /// <summary>
+            /// Build the descriptor that the engine uses to create a Grievance
+            /// </summary>
+            /// <param name="grievance">The Grievance to describe</param>
+            /// <param name="desc">The descriptor to fill in</param>
+            private static void CreateDescriptor(Grievance grievance, ref GameGrievanceDescriptor desc)
             {
-                GameGrievanceDescriptor desc = new GameGrievanceDescriptor();
+                desc = new GameGrievanceDescriptor();
 
                 // Transform Motivator
                 {
@@ -94,9 +114,37 @@ namespace RevengineEditor.DLLWrappers
                         }
                     }
                 }
+            }
+
+            // Import functions
+            [DllImport(_engineDLL)]
+            private static extern int CreateGrievance(ref GameGrievanceDescriptor desc);
+            public static int CreateGrievance(Grievance grievance)
+            {
+                GameGrievanceDescriptor desc = new GameGrievanceDescriptor();
+                CreateDescriptor(grievance, ref desc);
 
                 // Call DLL function to create the Grievance in the Engine
-                return CreateGrievance(desc);
+                return CreateGrievance(ref desc);
+            }
+
+            // Arrays of blittable types are pinned for the duration of the call, so the engine reads the descriptors in place
+            [DllImport(_engineDLL)]
+            private static extern uint CreateGrievances([In] GameGrievanceDescriptor[] descs, uint count, [Out] int[] ids);
+            public static int[] CreateGrievances(IList<Grievance> grievances)
+            {
+                int count = grievances.Count;
+                if (_descriptors.Length < count) _descriptors = new GameGrievanceDescriptor[count];
+
+                for (int i = 0; i < count; i++)
+                {
+                    CreateDescriptor(grievances[i], ref _descriptors[i]);
+                }
+
+                // Call DLL function to create all the Grievances in the Engine in one transition
+                int[] ids = new int[count];
+                if (count > 0) CreateGrievances(_descriptors, (uint)count, ids);
+                return ids;
             }
 
             [DllImport(_engineDLL)]
@@ -105,6 +153,21 @@ namespace RevengineEditor.DLLWrappers
             {
                 RemoveGrievance(grievance.GrievanceID);
             }
+
+            [DllImport(_engineDLL)]
+            private static extern void RemoveGrievances([In] int[] ids, uint count);
+            public static void RemoveGrievances(IList<Grievance> grievances)
+            {
+                // Only Grievances that are in the Engine can be removed from it
+                List<Grievance> active = grievances.Where(x => x.IsActive && ID.Isvalid(x.GrievanceID)).ToList();
+                int[] ids = active.Select(x => x.GrievanceID).ToArray();
+
+                // Call DLL function to remove all the Grievances from the Engine in one transition
+                if (ids.Length > 0) RemoveGrievances(ids, (uint)ids.Length);
+
+                // Mark the Grievances as inactive without removing them a second time
+                foreach (Grievance grievance in active) grievance.Deactivate();
+            }
         }
     }
 }
@@ -1,9 +1,11 @@
 ﻿using RevengineEditor.Components;
+using RevengineEditor.DLLWrappers;
 using RevengineEditor.Utilities;
 using System;
 using System.Collections.Generic;
 using System.Collections.ObjectModel;
 using System.Diagnostics;
+using System.Linq;
 using System.Runtime.Serialization;
 using System.Text;
 using System.Windows.Input;
@@ -116,10 +118,12 @@ namespace RevengineEditor.GameProject
                 OnPropertyChanged(nameof(Grievances));
             }
 
-            // Activate all Grievances so they can load into the engine
-            foreach(Grievance grievance in _grievances)
+            // Activate all Grievances so they can load into the engine, creating them in one batch
+            List<Grievance> inactive = _grievances.Where(x => !x.IsActive).ToList();
+            int[] ids = EngineAPI.GrievanceAPI.CreateGrievances(inactive);
+            for(int i = 0; i < inactive.Count; i++)
             {
-                grievance.IsActive = true;
+                inactive[i].Activate(ids[i]);
             }
 
             // Initialize Add Grievance Command
@@ -1,9 +1,53 @@
+#if defined(_MSC_VER)
 #pragma comment(lib, "engine.lib");
+#endif
 
+// Builds that pick the test themselves, like the CMake build, define TEST_SELECTED along with the test to run
+#if !defined(TEST_SELECTED)
 #define TEST_GRIEVANCE_MOTIVATORS 1
+#define TEST_HOT_RELOAD 0
+#define TEST_EVENT_BUS 0
+#define TEST_WORLD_SNAPSHOT 0
+#define TEST_TRANSFORM_REPLICATION 0
+#define TEST_PREFAB 0
+#define TEST_LOG 0
+#define TEST_RESOURCE 0
+#define TEST_ANIMATION 0
+#define TEST_MOTION 0
+#define TEST_CHANGE_JOURNAL 0
+#define TEST_PACKED_TRANSFORM 0
+#define TEST_RENDER_EXTRACTION 0
+#define TEST_LIFETIME 0
+#endif
 
 #if TEST_GRIEVANCE_MOTIVATORS
 #include "TestGrievancesMotivators.h"
+#elif TEST_HOT_RELOAD
+#include "TestHotReload.h"
+#elif TEST_EVENT_BUS
+#include "TestEventBus.h"
+#elif TEST_WORLD_SNAPSHOT
+#include "TestWorldSnapshot.h"
+#elif TEST_TRANSFORM_REPLICATION
+#include "TestTransformReplication.h"
+#elif TEST_PREFAB
+#include "TestPrefab.h"
+#elif TEST_LOG
+#include "TestLog.h"
+#elif TEST_RESOURCE
+#include "TestResource.h"
+#elif TEST_ANIMATION
+#include "TestAnimation.h"
+#elif TEST_MOTION
+#include "TestMotion.h"
+#elif TEST_CHANGE_JOURNAL
+#include "TestChangeJournal.h"
+#elif TEST_PACKED_TRANSFORM
+#include "TestPackedTransform.h"
+#elif TEST_RENDER_EXTRACTION
+#include "TestRenderExtraction.h"
+#elif TEST_LIFETIME
+#include "TestLifetime.h"
 #else
 #error One of these tests need to be enabled
 #endif
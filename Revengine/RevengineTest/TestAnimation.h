@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
+#include "../Engine/Components/Animation.h"
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+
+using namespace revengine;
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		// Pickups that bob up and down
+		animation::keyframe bob[3]{};
+		bob[1].time = 1.f;
+		bob[1].position[1] = 1.f;
+		bob[2].time = 2.f;
+		for (animation::keyframe& k : bob) k.ease = animation::easing::ease_in_out;
+
+		// Props that turn around the y axis, a third of a turn per second
+		animation::keyframe turn[4]{};
+		for (u32 i{ 0 }; i < 4; i++) {
+			const f32 half_angle{ (f32)i * math::pi / 3.f };
+			turn[i].time = (f32)i;
+			turn[i].rotation[1] = std::sin(half_angle);
+			turn[i].rotation[3] = std::cos(half_angle);
+		}
+
+		// Doors that slide open once
+		animation::keyframe slide[2]{};
+		slide[1].time = 0.5f;
+		slide[1].position[0] = 2.f;
+
+		animation::init_info bob_info{ bob, 3, animation::wrap_mode::loop, animation::channel::position };
+		animation::init_info turn_info{ turn, 4, animation::wrap_mode::loop, animation::channel::rotation };
+		animation::init_info slide_info{ slide, 2, animation::wrap_mode::once, animation::channel::position };
+		animation::init_info* infos[3]{ &bob_info, &turn_info, &slide_info };
+
+		transform::init_info transform_info{};
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			grievance::grievance_info grievance_info{ &transform_info, nullptr, infos[i % 3] };
+			_grievances.push_back(grievance::create(grievance_info));
+		}
+
+		return true;
+	}
+
+	void run() override {
+		do {
+			using clock = std::chrono::high_resolution_clock;
+
+			// Start every track over
+			for (const grievance::grievance& g : _grievances) g.animation().set_time(0.f);
+
+			// Step to a quarter of a second and check the results against the expected poses
+			animation::update(0.25f);
+			check(0.25f);
+
+			auto start{ clock::now() };
+			for (u32 frame{ 0 }; frame < _num_frames; frame++) animation::update(1.f / 60.f);
+			const f32 update_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() / _num_frames };
+
+			// The slides have finished by now and stopped at their end
+			for (u32 i{ 2 }; i < _num_grievances; i += 3) {
+				assert(!_grievances[i].animation().is_playing());
+				assert(_grievances[i].transform().position().x == 2.f);
+			}
+
+			print_results(update_ms);
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override {
+		for (const grievance::grievance& g : _grievances) grievance::remove(g.get_id());
+		_grievances.clear();
+	}
+
+private:
+	static constexpr u32 _num_grievances{ 30000 };
+	static constexpr u32 _num_frames{ 120 };
+
+	utl::vector<grievance::grievance> _grievances;
+
+	void check(f32 time) {
+		// Bobbing: smoothstep from 0 to 1 over the first second
+		const f32 bob_y{ time * time * (3.f - 2.f * time) };
+
+		// Turning: a third of a turn per second, and the quaternion holds half of the angle
+		const f32 half_angle{ time * math::pi / 3.f };
+
+		for (u32 i{ 0 }; i < _num_grievances; i += 3) {
+			const math::v3 position{ _grievances[i].transform().position() };
+			assert(std::abs(position.y - bob_y) < 1e-5f);
+
+			const math::v4 rotation{ _grievances[i + 1].transform().rotation() };
+			assert(std::abs(rotation.y - std::sin(half_angle)) < 1e-4f && std::abs(rotation.w - std::cos(half_angle)) < 1e-4f);
+
+			const math::v3 slide{ _grievances[i + 2].transform().position() };
+			assert(std::abs(slide.x - time / 0.5f * 2.f) < 1e-5f);
+		}
+	}
+
+	void print_results(f32 update_ms) {
+		// Print results
+		std::cout << "Sampled " << _num_grievances << " tracks: " << update_ms << "ms per update, "
+			<< update_ms * 1e6f / _num_grievances << "ns per track\n";
+	}
+};
\ No newline at end of file
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
+#include "../Engine/Components/Motion.h"
+#include "../Engine/Core/ChangeJournal.h"
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+
+using namespace revengine;
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		// A quarter of the grievances move every frame, the rest stand still
+		motion::init_info motion_info{};
+		motion_info.linear_velocity[1] = 1.f;
+		motion_info.angular_velocity[2] = 1.f;
+
+		transform::init_info transform_info{};
+		transform_info.rotation[3] = 1.f;
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			transform_info.position[0] = (f32)i;
+			grievance::grievance_info grievance_info{ &transform_info, nullptr, nullptr, i % 4 ? nullptr : &motion_info };
+			_grievances.push_back(grievance::create(grievance_info));
+		}
+
+		// The ring is smaller than the whole world on purpose, so that the first frames have to wait for the reader
+		if (!journal::initialize(_journal_name, _ring_size)) return false;
+
+		// Nobody else gets the name while the journal is alive
+		platform::shared_memory other{};
+		[[maybe_unused]] const bool taken{ !platform::create_shared_memory(_journal_name, 4096, other) };
+		assert(taken);
+
+		return _reader.open(_journal_name);
+	}
+
+	void run() override {
+		do {
+			using clock = std::chrono::high_resolution_clock;
+
+			// The reader runs on its own thread, like the editor would in its own process
+			_stop = false;
+			_ranges = 0;
+			std::thread consumer{ [this]() {
+				while (!_stop.load(std::memory_order_acquire)) {
+					if (!_reader.read(&engine_test::apply, this)) std::this_thread::yield();
+				}
+
+				_reader.read(&engine_test::apply, this);
+			} };
+
+			u32 sent{ 0 };
+			f32 record_ms{ 0.f };
+			for (u32 frame{ 0 }; frame < _num_frames; frame++) {
+				motion::update(1.f / 60.f);
+
+				// Remove a few grievances along the way
+				if (frame == _num_frames / 2) {
+					for (u32 i{ 1 }; i < _grievances.size(); i += 97) {
+						if (grievance::is_alive(_grievances[i].get_id())) grievance::remove(_grievances[i].get_id());
+					}
+				}
+
+				const auto start{ clock::now() };
+				sent += journal::record();
+				record_ms += std::chrono::duration<f32, std::milli>(clock::now() - start).count();
+			}
+
+			// Keep recording until nothing is left over from frames that didn't fit into the ring
+			while (!journal::is_synced()) {
+				std::this_thread::yield();
+				journal::record();
+			}
+
+			_stop.store(true, std::memory_order_release);
+			consumer.join();
+
+			check();
+			check_refill();
+			check_corrupt();
+			print_results(sent, record_ms / _num_frames);
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override {
+		_reader.close();
+		journal::shutdown();
+		for (const grievance::grievance& g : _grievances) {
+			if (grievance::is_alive(g.get_id())) grievance::remove(g.get_id());
+		}
+
+		_grievances.clear();
+	}
+
+private:
+	static constexpr const char* _journal_name{ "RevengineTestJournal" };
+	static constexpr u32 _num_grievances{ 50000 };
+	static constexpr u32 _num_frames{ 120 };
+	static constexpr u32 _ring_size{ 512 * 1024 };
+
+	utl::vector<grievance::grievance> _grievances;
+	journal::reader _reader;
+	std::atomic<bool> _stop{ false };
+
+	// The reader's copy of the world, only touched by the consumer thread while it runs
+	utl::vector<journal::transform_data> _mirror;
+	utl::vector<u8> _mirror_alive;
+	utl::vector<u32> _mirror_removals; // How often each index was sent as removed
+	u64 _ranges{ 0 };
+
+	static void apply(const journal::range_header& range, const journal::transform_data* data, u64, void* user_data) {
+		engine_test& test{ *static_cast<engine_test*>(user_data) };
+		if (test._mirror.size() < range.first + range.count) {
+			test._mirror.resize(range.first + range.count);
+			test._mirror_alive.resize(range.first + range.count, 0);
+			test._mirror_removals.resize(range.first + range.count, 0);
+		}
+
+		if (!data) {
+			for (u32 i{ range.first }; i < range.first + range.count; i++) ++test._mirror_removals[i];
+		}
+
+		if (data) memcpy(&test._mirror[range.first], data, range.count * sizeof(journal::transform_data));
+		memset(&test._mirror_alive[range.first], data ? 1 : 0, range.count);
+		++test._ranges;
+	}
+
+	void check() {
+		// The reader's copy has to match the engine exactly. Removed grievances may have handed their index to a new one
+		utl::vector<u8> alive(_mirror_alive.size(), 0);
+		for (const grievance::grievance& g : _grievances) {
+			if (!grievance::is_alive(g.get_id())) continue;
+
+			const id::id_type index{ id::index(g.get_id()) };
+			assert(index < _mirror_alive.size() && _mirror_alive[index]);
+			alive[index] = 1;
+
+			[[maybe_unused]] const journal::transform_data& mirrored{ _mirror[index] };
+			const transform::motivator t{ g.transform() };
+			[[maybe_unused]] const journal::transform_data current{ t.position(), t.rotation(), t.scale() };
+			assert(!memcmp(&mirrored, &current, sizeof(journal::transform_data)));
+		}
+
+		assert(!memcmp(alive.data(), _mirror_alive.data(), alive.size()));
+	}
+
+	void sync() {
+		do {
+			journal::record();
+			while (_reader.read(&engine_test::apply, this)) {}
+		} while (!journal::is_synced());
+	}
+
+	void check_refill() {
+		// Forget the grievances that were removed before their indices are reused, as they can't be checked after that
+		_grievances.erase(std::remove_if(_grievances.begin(), _grievances.end(),
+			[](const grievance::grievance& g) { return !grievance::is_alive(g.get_id()); }), _grievances.end());
+
+		// Remove enough grievances that their indices are reused right away, and create new ones in the same frame
+		utl::vector<u32> removed_positions;
+		utl::vector<u32> removed_indices;
+		for (u32 i{ 2 }; i < _grievances.size(); i += 20) {
+			removed_positions.push_back(i);
+			removed_indices.push_back(id::index(_grievances[i].get_id()));
+			grievance::remove(_grievances[i].get_id());
+		}
+
+		const utl::vector<u32> removals_before{ _mirror_removals };
+		transform::init_info transform_info{};
+		transform_info.rotation[3] = 1.f;
+		transform_info.position[1] = -1.f;
+		for (const u32 position : removed_positions) {
+			grievance::grievance_info grievance_info{ &transform_info };
+			_grievances[position] = grievance::create(grievance_info);
+		}
+
+		sync();
+		check();
+
+		// A reader holding the old grievance of a reused index has to be told that it is gone
+		u32 reused{ 0 };
+		for (const u32 index : removed_indices) {
+			assert(_mirror_removals[index] > removals_before[index]);
+			if (_mirror_alive[index]) ++reused;
+		}
+
+		assert(reused);
+	}
+
+	void check_corrupt() {
+		// Write broken messages into the ring the way a writer that doesn't agree with the layout would
+		platform::shared_memory memory{};
+		[[maybe_unused]] const bool opened{ platform::open_shared_memory(_journal_name, sizeof(journal::ring_header) + _ring_size, memory) };
+		assert(opened);
+		journal::ring_header& header{ *(journal::ring_header*)memory.data };
+		u8* const ring{ memory.data + sizeof(journal::ring_header) };
+		const u64 write{ header.write_position.load(std::memory_order_relaxed) };
+
+		const auto send{ [&](const u8* data, u32 size) {
+			for (u32 i{ 0 }; i < size; i++) ring[(write + i) & (header.capacity - 1)] = data[i];
+			header.write_position.store(write + size, std::memory_order_release);
+
+			// The reader stops at the message, and the journal has to be opened again once the writer is fixed
+			[[maybe_unused]] const u32 read{ _reader.read(&engine_test::apply, this) };
+			assert(!read && !_reader.is_open() && header.read_position.load(std::memory_order_relaxed) == write);
+			header.write_position.store(write, std::memory_order_release);
+			[[maybe_unused]] const bool reopened{ _reader.open(_journal_name) };
+			assert(reopened);
+		} };
+
+		// A range with more transforms than the message holds
+		struct {
+			journal::message_header m;
+			journal::range_header range;
+		} message{ { sizeof(message), 1, 0 }, { journal::change::transform, 0, 1000, 0 } };
+		send((const u8*)&message, sizeof(message));
+
+		// A message that claims to be bigger than what was written
+		message = { { 1024, 1, 0 }, { journal::change::removed, 0, 1, 0 } };
+		send((const u8*)&message, sizeof(message));
+
+		// A size that doesn't even cover the header
+		message = { { 4, 0, 0 }, {} };
+		send((const u8*)&message, sizeof(message));
+
+		platform::close_shared_memory(memory);
+		sync();
+		check();
+	}
+
+	void print_results(u32 sent, f32 record_ms) {
+		// Print results
+		std::cout << "Sent " << sent << " grievance updates in " << _ranges << " ranges over " << _num_frames << " frames, "
+			<< record_ms << "ms per record\n";
+	}
+};
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Core/EventBus.h"
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+using namespace revengine;
+
+struct damage_event {
+	u32 source;
+	f32 amount;
+};
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		// Subscribe to every damage event, and to the ones aimed at the first target
+		events::subscribe<damage_event>(&engine_test::on_damage, this);
+		events::subscribe<damage_event>(&engine_test::on_targeted_damage, this, grievance::grievance_id{ 0 });
+		return true;
+	}
+
+	void run() override {
+		do {
+			_received = 0;
+			_targeted = 0;
+
+			const auto start{ std::chrono::high_resolution_clock::now() };
+
+			// Post events from several threads at once, each into their own queue
+			utl::vector<std::thread> producers;
+			for (u32 t{ 0 }; t < _num_threads; t++) {
+				producers.emplace_back([t]() {
+					for (u32 i{ 0 }; i < _events_per_thread; i++) {
+						const damage_event e{ t, (f32)i };
+						const bool result{ events::post(e, grievance::grievance_id{ i % _num_targets }) };
+						assert(result);
+					}
+				});
+			}
+
+			for (std::thread& producer : producers) producer.join();
+
+			// Deliver everything in one batch
+			events::dispatch();
+
+			const auto end{ std::chrono::high_resolution_clock::now() };
+			const f32 ms{ std::chrono::duration<f32, std::milli>(end - start).count() };
+
+			// Confirm that every event arrived and that targeted subscribers only saw their own events
+			assert(_received == _num_threads * _events_per_thread);
+			assert(_targeted == _num_threads * (_events_per_thread / _num_targets));
+			assert(events::view<damage_event>(grievance::grievance_id{ 1 }).count == _targeted);
+
+			print_results(ms);
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override {
+		events::shutdown();
+	}
+
+private:
+	static constexpr u32 _num_threads{ 4 };
+	static constexpr u32 _events_per_thread{ 10000 };
+	static constexpr u32 _num_targets{ 100 };
+
+	u32 _received{ 0 };
+	u32 _targeted{ 0 };
+
+	static void on_damage(const damage_event*, const grievance::grievance_id*, u32 count, void* user_data) {
+		static_cast<engine_test*>(user_data)->_received += count;
+	}
+
+	static void on_targeted_damage(const damage_event*, const grievance::grievance_id* targets, u32 count, void* user_data) {
+		// The whole range belongs to the subscribed grievance
+		for (u32 i{ 0 }; i < count; i++) assert(targets[i] == grievance::grievance_id{ 0 });
+		static_cast<engine_test*>(user_data)->_targeted += count;
+	}
+
+	void print_results(f32 ms) {
+		// Print results
+		std::cout << "Events delivered: " << _received << "\n";
+		std::cout << "Targeted events delivered: " << _targeted << "\n";
+		std::cout << "Post and dispatch time: " << ms << "ms\n";
+	}
+};
\ No newline at end of file
@@ -0,0 +1,12 @@
+#include "../Engine/Common/CommonHeaders.h"
+
+// Stands in for game code in the hot reload test, which loads it as a module and looks for this function
+#if defined(_WIN64)
+#define GAME_CODE_EXPORT extern "C" __declspec(dllexport)
+#else
+#define GAME_CODE_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+GAME_CODE_EXPORT u32 game_code_version() {
+	return 1;
+}
\ No newline at end of file
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "Test.h"
-#include "..\Engine\Components\Grievance.h"
-#include "..\Engine\Components\Transform.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
 
 #include <iostream>
 #include <ctime>
@@ -23,7 +23,11 @@ public:
 				create_random();
 				remove_random();
 				_num_grievances = (u32)_grievances.size();
+
+				// Compact the transform data a little every iteration, like a frame would
+				transform::defragment(64);
 			}
+			check_transforms();
 			print_results();
 		} while (getchar() != 'q');
 	}
@@ -31,6 +35,7 @@ public:
 
 private:
 	utl::vector<grievance::grievance> _grievances;
+	utl::vector<f32> _positions;
 	
 	u32 _added{ 0 };
 	u32 _removed{ 0 };
@@ -53,6 +58,9 @@ private:
 			// Increment countt
 			_added++;
 
+			// Give every grievance a position that can be checked after its data was moved
+			transform_info.position[0] = (f32)_added;
+
 			// Create a new grievance
 			grievance::grievance grievance{ grievance::create(grievance_info) };
 
@@ -61,6 +69,7 @@ private:
 
 			// Add the grievance to the vector
 			_grievances.push_back(grievance);
+			_positions.push_back(transform_info.position[0]);
 
 			assert(grievance::is_alive(grievance.get_id()));
 
@@ -93,6 +102,7 @@ private:
 			if (grievance.is_valid()) {
 				grievance::remove(grievance.get_id());
 				_grievances.erase(_grievances.begin() + index);
+				_positions.erase(_positions.begin() + index);
 				assert(!grievance::is_alive(grievance.get_id()));
 			}
 
@@ -101,6 +111,13 @@ private:
 		}
 	}
 
+	void check_transforms() {
+		// Confirm that defragmenting kept every grievance pointing to its own transform data
+		for (u32 i{ 0 }; i < _grievances.size(); i++) {
+			assert(_grievances[i].transform().position().x == _positions[i]);
+		}
+	}
+
 	void print_results() {
 		// Print results
 		std::cout << "Grievances created: " << _added << "\n";
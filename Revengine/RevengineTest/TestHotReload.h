@@ -0,0 +1,194 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
+#include "../Engine/Components/Script.h"
+#include "../Engine/Platform/Module.h"
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+using namespace revengine;
+
+// Every live counter, so that the test can look at the instances the engine created
+class counter_base;
+std::unordered_map<id::id_type, counter_base*> live_counters;
+
+class counter_base : public script::grievance_script {
+public:
+	explicit counter_base(revengine::grievance::grievance grievance) : revengine::script::grievance_script{ grievance } {
+		live_counters[get_id()] = this;
+	}
+
+	~counter_base() override { live_counters.erase(get_id()); }
+
+	virtual u32 version() const = 0;
+	u32 count() const { return _count; }
+	void set_count(u32 count) { _count = count; }
+
+	u32 serialize(u8* buffer, u32 size) const override {
+		if (size >= sizeof(u32)) memcpy(buffer, &_count, sizeof(u32));
+		return sizeof(u32);
+	}
+
+	void deserialize(const u8* data, u32 size) override {
+		assert(size == sizeof(u32));
+		memcpy(&_count, data, sizeof(u32));
+	}
+
+private:
+	u32 _count{ 0 };
+};
+
+// The same script before and after the game code was rebuilt
+class counter_v1 : public counter_base {
+public:
+	explicit counter_v1(revengine::grievance::grievance grievance) : counter_base{ grievance } {}
+	u32 version() const override { return 1; }
+};
+
+class counter_v2 : public counter_base {
+public:
+	explicit counter_v2(revengine::grievance::grievance grievance) : counter_base{ grievance } {}
+	u32 version() const override { return 2; }
+};
+
+// A script that was deleted from the rebuilt game code
+class deleted_script : public script::grievance_script {
+public:
+	explicit deleted_script(revengine::grievance::grievance grievance) : revengine::script::grievance_script{ grievance } {}
+};
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		check_module_copy();
+
+		transform::init_info transform_info{};
+		transform_info.rotation[3] = 1.f;
+		script::init_info counter_info{ &script::detail::create_script<counter_v1> };
+		script::init_info deleted_info{ &script::detail::create_script<deleted_script> };
+
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			grievance::grievance_info grievance_info{ &transform_info, i % 4 ? &counter_info : &deleted_info };
+			const grievance::grievance g{ grievance::create(grievance_info) };
+			_grievances.push_back(g);
+			if (i % 4) live_counters[g.get_id()]->set_count(i);
+		}
+
+		return true;
+	}
+
+	void run() override {
+		do {
+			using clock = std::chrono::high_resolution_clock;
+
+			// Swap in the rebuilt game code
+			reload_state state{ false, 0 };
+			auto start{ clock::now() };
+			[[maybe_unused]] u32 recreated{ script::hot_reload(&swap_module, &rebind_creator, &state) };
+			const f32 reload_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+			assert(state.swaps == 1 && recreated == _num_counters);
+			check_counters(2);
+
+			// A module that fails to load leaves the current code in place, and every script keeps its state
+			state.fail = true;
+			recreated = script::hot_reload(&swap_module, &rebind_creator, &state);
+			assert(state.swaps == 1 && recreated == _num_counters);
+			check_counters(2);
+
+			// Go back to the first version for the next run. The deleted script is gone for good
+			state = { false, 0 };
+			state.back = true;
+			recreated = script::hot_reload(&swap_module, &rebind_creator, &state);
+			assert(recreated == _num_counters);
+			check_counters(1);
+
+			std::cout << "Reloaded " << _num_counters << " scripts of " << _num_grievances << " grievances in " << reload_ms << "ms\n";
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override {
+		for (const grievance::grievance& g : _grievances) grievance::remove(g.get_id());
+		_grievances.clear();
+		assert(live_counters.empty());
+	}
+
+private:
+	static constexpr u32 _num_grievances{ 10000 };
+	static constexpr u32 _num_counters{ _num_grievances - _num_grievances / 4 };
+
+	struct reload_state {
+		bool fail;
+		u32 swaps;
+		bool back{ false };
+	};
+
+	utl::vector<grievance::grievance> _grievances;
+
+	// The test can't rebuild a DLL, so the two versions of the game code live in the test itself, and swapping
+	// only decides which creators the old ones are rebound to
+	static bool swap_module(void* user_data) {
+		reload_state& state{ *(reload_state*)user_data };
+		if (state.fail) return false;
+		++state.swaps;
+		return true;
+	}
+
+	static script::detail::script_creator rebind_creator(script::detail::script_creator old_creator, void* user_data) {
+		const reload_state& state{ *(const reload_state*)user_data };
+		const script::detail::script_creator v1{ &script::detail::create_script<counter_v1> };
+		const script::detail::script_creator v2{ &script::detail::create_script<counter_v2> };
+
+		if (old_creator == v1 || old_creator == v2) return state.back ? v1 : v2;
+		return nullptr;
+	}
+
+	void check_counters(u32 version) {
+		// Every counter was recreated from the new code with the count it had, and deleted scripts have no instance
+		assert(live_counters.size() == _num_counters);
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			const auto it{ live_counters.find(_grievances[i].get_id()) };
+			if (!(i % 4)) {
+				assert(it == live_counters.end() && _grievances[i].script().is_valid());
+				continue;
+			}
+
+			assert(it != live_counters.end() && it->second->version() == version && it->second->count() == i);
+		}
+	}
+
+	void check_module_copy() {
+		// A file that isn't a module fails to load, and its copy is deleted again
+		const char* const path{ "revengine_test_module.bin" };
+		const char* const copy_path{ "revengine_test_module.bin.reload0" };
+		{
+			std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+			file << "not a module";
+		}
+
+		[[maybe_unused]] const platform::module_handle module{ platform::load_module_copy(path, copy_path) };
+		assert(!module && !std::filesystem::exists(copy_path));
+		std::filesystem::remove(path);
+
+#if defined(TEST_GAME_CODE_PATH)
+		// Builds that come with a game code module load a copy of it, which is deleted again once it's unloaded
+		const std::string game_code_copy{ std::string{ TEST_GAME_CODE_PATH } + ".reload0" };
+		const platform::module_handle game_code{ platform::load_module_copy(TEST_GAME_CODE_PATH, game_code_copy.c_str()) };
+		assert(game_code && std::filesystem::exists(game_code_copy));
+
+		using version_function = u32(*)();
+		[[maybe_unused]] const version_function game_code_version{ (version_function)platform::get_symbol(game_code, "game_code_version") };
+		assert(game_code_version && game_code_version() == 1);
+
+		[[maybe_unused]] const bool unloaded{ platform::unload_module_copy(game_code, game_code_copy.c_str()) };
+		assert(unloaded && !std::filesystem::exists(game_code_copy));
+#endif
+	}
+};
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
+#include "../Engine/Components/Lifetime.h"
+#include "../Engine/Core/WorldSnapshot.h"
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+
+using namespace revengine;
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		transform::init_info transform_info{};
+		transform_info.rotation[3] = 1.f;
+		lifetime::init_info lifetime_info{};
+		grievance::grievance_info grievance_info{ &transform_info };
+		grievance_info.lifetime = &lifetime_info;
+
+		// Lifetimes are whole amounts of ticks, spread out far enough that they start on the first two levels
+		// of the wheel and have to move down through them
+		_expiring.resize(_max_ticks + 1, 0);
+		for (u32 i{ 0 }; i < _num_timed; i++) {
+			u32 ticks{ 1 + (i * 7919) % _max_ticks };
+			lifetime_info.seconds = (f32)ticks * lifetime::tick_length;
+			const grievance::grievance g{ grievance::create(grievance_info) };
+
+			if (i % 10 == 0) {
+				// Give some of them a new lifetime
+				ticks = ticks / 2 + 1;
+				g.lifetime().set_remaining((f32)ticks * lifetime::tick_length);
+				assert(g.lifetime().remaining() == (f32)ticks * lifetime::tick_length);
+			}
+			else if (i % 10 == 1) {
+				// Remove some of them before their time is up, which takes them out of the wheel
+				grievance::remove(g.get_id());
+				continue;
+			}
+
+			++_expiring[ticks];
+		}
+
+		// Lifetimes this long sit on the last level of the wheel and are never touched during the test
+		lifetime_info.seconds = _idle_seconds;
+		for (u32 i{ 0 }; i < _num_idle; i++) _idle.push_back(grievance::create(grievance_info));
+
+		// Every run starts from here
+		snapshot::capture(_start);
+		return true;
+	}
+
+	void run() override {
+		do {
+			using clock = std::chrono::high_resolution_clock;
+
+			// Step one tick at a time, and check that every grievance is removed in the tick its lifetime runs out
+			snapshot::restore(_start);
+			auto start{ clock::now() };
+			for (u32 tick{ 1 }; tick <= _max_ticks; tick++) {
+				const u32 removed{ lifetime::update(lifetime::tick_length) };
+				assert(removed == _expiring[tick]);
+			}
+			const f32 expire_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+
+			// Bigger steps cover several ticks, and remove everything of all of them in one go
+			snapshot::restore(_start);
+			u32 removed{ 0 };
+			u32 expected{ 0 };
+			for (u32 tick{ 1 }; tick <= _max_ticks; tick++) {
+				expected += _expiring[tick];
+				if (tick % 16) continue;
+				removed += lifetime::update(16 * lifetime::tick_length);
+				assert(removed == expected);
+			}
+
+			// With only the long lifetimes left, an update only looks at one empty slot per tick
+			start = clock::now();
+			for (u32 frame{ 0 }; frame < _num_frames; frame++) {
+				removed = lifetime::update(_dt);
+				assert(!removed);
+			}
+			const f32 idle_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() / _num_frames };
+
+			for (const grievance::grievance& g : _idle) {
+				assert(std::abs(g.lifetime().remaining() - (_idle_seconds - _max_ticks * lifetime::tick_length - _num_frames * _dt)) < 2.f);
+			}
+
+			print_results(expire_ms, idle_ms);
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override {
+		for (const grievance::grievance& g : _idle) grievance::remove(g.get_id());
+		_idle.clear();
+	}
+
+private:
+	static constexpr u32 _num_timed{ 100000 };
+	static constexpr u32 _num_idle{ 200000 };
+	static constexpr u32 _max_ticks{ 140000 }; // About 36 minutes
+	static constexpr u32 _num_frames{ 600 };
+	static constexpr f32 _dt{ 1.f / 60.f };
+	static constexpr f32 _idle_seconds{ 1e7f };
+
+	utl::vector<u32> _expiring; // The amount of grievances that run out in each tick
+	utl::vector<grievance::grievance> _idle;
+	snapshot::world_snapshot _start;
+
+	void print_results(f32 expire_ms, f32 idle_ms) {
+		// Print results
+		u32 removed{ 0 };
+		for (u32 count : _expiring) removed += count;
+
+		std::cout << "Removed " << removed << " grievances over " << _max_ticks << " ticks in " << expire_ms
+			<< "ms, idle update with " << _num_idle << " waiting lifetimes: " << idle_ms * 1e3f << "us\n";
+	}
+};
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Core/Log.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+
+using namespace revengine;
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		return true;
+	}
+
+	void run() override {
+		do {
+			if (!log::initialize(_path)) {
+				std::cout << "Couldn't open " << _path << "\n";
+				return;
+			}
+
+			// Log from several threads at once, and time each thread's calls
+			utl::vector<std::thread> threads;
+			utl::vector<f32> thread_ns(_num_threads);
+			for (u32 i{ 0 }; i < _num_threads; i++) {
+				threads.emplace_back([i, &thread_ns]() { thread_ns[i] = write_records(i); });
+			}
+
+			for (std::thread& thread : threads) thread.join();
+			log::shutdown();
+
+			print_results(thread_ns);
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override {
+		log::shutdown();
+	}
+
+private:
+	static constexpr const char* _path{ "revengine_test.log" };
+	static constexpr u32 _num_threads{ 4 };
+	static constexpr u32 _records_per_batch{ 1000 };
+	static constexpr u32 _num_batches{ 50 };
+
+	static f32 write_records(u32 thread) {
+		using clock = std::chrono::high_resolution_clock;
+		f32 total_ns{ 0.f };
+
+		// Log in batches and give the writer time to catch up in between, like a busy frame would
+		for (u32 batch{ 0 }; batch < _num_batches; batch++) {
+			const auto start{ clock::now() };
+			for (u32 i{ 0 }; i < _records_per_batch; i++) {
+				LOG_WARNING("Thread {} record {} at {} with {}", thread, batch * _records_per_batch + i, 0.5f * i, "a string");
+			}
+			total_ns += std::chrono::duration<f32, std::nano>(clock::now() - start).count();
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+
+		return total_ns / (_num_batches * _records_per_batch);
+	}
+
+	void print_results(const utl::vector<f32>& thread_ns) {
+		// Read the records back, and count the ones that were dropped
+		std::ifstream file{ _path };
+		std::string line;
+		u32 records{ 0 };
+		u32 dropped{ 0 };
+		u32 drop_warnings{ 0 };
+		utl::vector<s64> last_record(_num_threads, -1);
+		utl::vector<double> last_time(_num_threads, -1.0);
+
+		while (std::getline(file, line)) {
+			u32 count{ 0 };
+			if (sscanf(line.c_str(), "[WARNING] %u log records were dropped", &count) == 1) {
+				dropped += count;
+				++drop_warnings;
+				continue;
+			}
+
+			double time{ 0.0 };
+			u32 thread{ 0 };
+			u32 record{ 0 };
+			[[maybe_unused]] const s32 fields{ sscanf(line.c_str(), "[%lfms] [WARNING] Thread %u record %u", &time, &thread, &record) };
+			assert(fields == 3 && thread < _num_threads);
+
+			// The text has to be the format with the arguments filled in
+			char expected[128];
+			snprintf(expected, sizeof(expected), "[WARNING] Thread %u record %u at %g with a string (", thread, record,
+				(double)(0.5f * (record % _records_per_batch)));
+			assert(line.find(expected) != std::string::npos);
+
+			// Each thread's records come in the order they were logged, and their times never go back
+			assert((s64)record > last_record[thread] && time >= last_time[thread]);
+			last_record[thread] = record;
+			last_time[thread] = time;
+			++records;
+		}
+
+		// Every record that was logged was either written or counted as dropped
+		const u32 logged{ _num_threads * _num_batches * _records_per_batch };
+		assert(records + dropped == logged);
+
+		// Print results
+		std::cout << "Wrote " << records << " of " << logged << " records";
+		if (dropped) std::cout << " (" << dropped << " dropped in " << drop_warnings << " warnings)";
+		std::cout << "\n";
+		for (u32 i{ 0 }; i < _num_threads; i++) std::cout << "    Thread " << i << ": " << thread_ns[i] << "ns per record\n";
+	}
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
+#include "../Engine/Components/Motion.h"
+#include "../Engine/Core/WorldSnapshot.h"
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+using namespace revengine;
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		// Every other grievance is a projectile that flies forward, falls, and spins around the y axis.
+		// The rest are static and have no motion component at all
+		motion::init_info motion_info{};
+		motion_info.linear_acceleration[1] = -_gravity;
+		motion_info.angular_velocity[1] = _spin;
+
+		transform::init_info transform_info{};
+		transform_info.rotation[3] = 1.f;
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			transform_info.position[0] = (f32)i;
+			motion_info.linear_velocity[0] = (f32)(i % 10);
+			grievance::grievance_info grievance_info{ &transform_info, nullptr, nullptr, i & 1 ? &motion_info : nullptr };
+			_grievances.push_back(grievance::create(grievance_info));
+		}
+
+		assert(motion::count() == _num_grievances / 2);
+
+		// Every run starts from here
+		snapshot::capture(_start);
+		return true;
+	}
+
+	void run() override {
+		do {
+			using clock = std::chrono::high_resolution_clock;
+
+			// Split the moving grievances into ranges and integrate each range on its own thread
+			snapshot::restore(_start);
+			integrate_in_parallel();
+			check();
+
+			// Time the integration of everything on one thread
+			snapshot::restore(_start);
+			auto start{ clock::now() };
+			for (u32 frame{ 0 }; frame < _num_frames; frame++) motion::update(_dt);
+			const f32 update_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() / _num_frames };
+			check();
+
+			print_results(update_ms);
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override {
+		for (const grievance::grievance& g : _grievances) grievance::remove(g.get_id());
+		_grievances.clear();
+	}
+
+private:
+	static constexpr u32 _num_grievances{ 200000 };
+	static constexpr u32 _num_frames{ 60 };
+	static constexpr u32 _num_threads{ 4 };
+	static constexpr f32 _dt{ 1.f / 60.f };
+	static constexpr f32 _gravity{ 9.8f };
+	static constexpr f32 _spin{ math::pi }; // Half a turn per second
+
+	utl::vector<grievance::grievance> _grievances;
+	snapshot::world_snapshot _start;
+
+	void integrate_in_parallel() {
+		const u32 count{ motion::count() };
+		const u32 range{ (count + _num_threads - 1) / _num_threads };
+
+		// The ranges don't overlap, so every thread can run through all frames without waiting for the others
+		std::thread threads[_num_threads];
+		for (u32 t{ 0 }; t < _num_threads; t++) {
+			const u32 first{ std::min(t * range, count) };
+			const u32 size{ std::min(range, count - first) };
+			threads[t] = std::thread{ [first, size]() {
+				for (u32 frame{ 0 }; frame < _num_frames; frame++) motion::integrate(_dt, first, size);
+			} };
+		}
+
+		for (std::thread& thread : threads) thread.join();
+	}
+
+	void check() {
+		// Semi-implicit Euler updates the velocity before moving, so after n steps the position is
+		// p0 + n * v0 * dt + a * dt^2 * n * (n + 1) / 2
+		const f32 n{ (f32)_num_frames };
+		const f32 fall{ -_gravity * _dt * _dt * n * (n + 1.f) * 0.5f };
+		const f32 half_angle{ n * _spin * _dt * 0.5f };
+
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			const math::v3 position{ _grievances[i].transform().position() };
+			const math::v4 rotation{ _grievances[i].transform().rotation() };
+
+			if (!(i & 1)) {
+				// Static grievances stay exactly where they were
+				assert(!_grievances[i].motion().is_valid());
+				assert(position.x == (f32)i && position.y == 0.f && rotation.w == 1.f);
+				continue;
+			}
+
+			const f32 x{ (f32)i + n * (f32)(i % 10) * _dt };
+			assert(std::abs(position.x - x) < 1e-3f * std::max(1.f, x));
+			assert(std::abs(position.y - fall) < 1e-3f);
+			assert(std::abs(rotation.y - std::sin(half_angle)) < 1e-4f && std::abs(rotation.w - std::cos(half_angle)) < 1e-4f);
+		}
+	}
+
+	void print_results(f32 update_ms) {
+		const u32 count{ motion::count() };
+
+		// Print results
+		std::cout << "Integrated " << count << " moving of " << _num_grievances << " grievances: " << update_ms << "ms per update, "
+			<< update_ms * 1e6f / count << "ns per moving grievance\n";
+	}
+};
\ No newline at end of file
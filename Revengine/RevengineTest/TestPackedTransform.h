@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
+#include "../Engine/Components/PackedTransform.h"
+
+#include <iostream>
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <cstring>
+
+using namespace revengine;
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		// Get a random seed
+		srand((u32)time(nullptr));
+
+		// A big world of transforms, most of them with a uniform scale
+		_positions.resize(_num_transforms);
+		_rotations.resize(_num_transforms);
+		_scales.resize(_num_transforms);
+		for (u32 i{ 0 }; i < _num_transforms; i++) {
+			_positions[i] = { random(-4000.f, 4000.f), random(-50.f, 200.f), random(-4000.f, 4000.f) };
+			random_rotation(&_rotations[i].x);
+			const f32 scale{ i % 8 ? 1.f : random(0.5f, 2.f) };
+			_scales[i] = { scale, scale, scale };
+		}
+
+		_unpacked_positions.resize(_num_transforms);
+		_unpacked_rotations.resize(_num_transforms);
+		_unpacked_scales.resize(_num_transforms);
+
+		// A world of grievances to pack and unpack
+		transform::init_info transform_info{};
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			for (u32 j{ 0 }; j < 3; j++) transform_info.position[j] = random(-100.f, 100.f);
+			random_rotation(transform_info.rotation);
+			grievance::grievance_info grievance_info{ &transform_info };
+			_grievances.push_back(grievance::create(grievance_info));
+		}
+
+		return true;
+	}
+
+	void run() override {
+		do {
+			// Reading the full precision arrays, as the baseline
+			using clock = std::chrono::high_resolution_clock;
+			auto start{ clock::now() };
+			memcpy(_unpacked_positions.data(), _positions.data(), _num_transforms * sizeof(math::v3));
+			memcpy(_unpacked_rotations.data(), _rotations.data(), _num_transforms * sizeof(math::v4));
+			memcpy(_unpacked_scales.data(), _scales.data(), _num_transforms * sizeof(math::v3));
+			const f32 copy_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+			std::cout << "Full precision: " << (f32)full_size / _num_transforms << " bytes per transform, read in " << copy_ms << "ms\n";
+
+			measure({ 10, transform::scale_mode::uniform, 128.f }, true, 0.002f);
+			measure({ 10, transform::scale_mode::half, 0.f }, true, 0.f);
+			measure({ 8, transform::scale_mode::uniform, 256.f }, true, 0.005f);
+
+			check_cells();
+			check_world();
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override {
+		for (const grievance::grievance& g : _grievances) grievance::remove(g.get_id());
+		_grievances.clear();
+	}
+
+private:
+	static constexpr u32 _num_transforms{ 1000000 };
+	static constexpr u32 _num_grievances{ 100000 };
+	static constexpr u64 full_size{ (u64)_num_transforms * (2 * sizeof(math::v3) + sizeof(math::v4)) };
+
+	utl::vector<math::v3> _positions;
+	utl::vector<math::v4> _rotations;
+	utl::vector<math::v3> _scales;
+	utl::vector<math::v3> _unpacked_positions;
+	utl::vector<math::v4> _unpacked_rotations;
+	utl::vector<math::v3> _unpacked_scales;
+	utl::vector<grievance::grievance> _grievances;
+	transform::packed_transforms _packed;
+
+	static f32 random(f32 min, f32 max) {
+		return min + (max - min) * (f32)rand() / (f32)RAND_MAX;
+	}
+
+	static void random_rotation(f32* q) {
+		f32 length{ 0.f };
+		while (length < 0.01f) {
+			length = 0.f;
+			for (u32 i{ 0 }; i < 4; i++) {
+				q[i] = random(-1.f, 1.f);
+				length += q[i] * q[i];
+			}
+		}
+
+		length = std::sqrt(length);
+		for (u32 i{ 0 }; i < 4; i++) q[i] /= length;
+	}
+
+	void measure(const transform::packed_config& config, bool expect_exact, f32 position_error) {
+		using clock = std::chrono::high_resolution_clock;
+
+		auto start{ clock::now() };
+		const bool exact{ transform::pack(config, _positions.data(), _rotations.data(), _scales.data(), _num_transforms, _packed) };
+		const f32 pack_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+		assert(exact == expect_exact);
+
+		start = clock::now();
+		transform::unpack(_packed, 0, _num_transforms, _unpacked_positions.data(), _unpacked_rotations.data(), _unpacked_scales.data());
+		const f32 unpack_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+
+		// Compare against the originals
+		f32 max_position{ 0.f };
+		f32 max_angle{ 0.f };
+		f32 max_scale{ 0.f };
+		for (u32 i{ 0 }; i < _num_transforms; i++) {
+			const math::v3& p{ _positions[i] };
+			const math::v3& up{ _unpacked_positions[i] };
+			max_position = std::max(max_position, std::max(std::abs(p.x - up.x), std::max(std::abs(p.y - up.y), std::abs(p.z - up.z))));
+
+			const math::v4& q{ _rotations[i] };
+			const math::v4& uq{ _unpacked_rotations[i] };
+			const f32 dot{ std::min(1.f, std::abs(q.x * uq.x + q.y * uq.y + q.z * uq.z + q.w * uq.w)) };
+			max_angle = std::max(max_angle, 2.f * std::acos(dot));
+
+			max_scale = std::max(max_scale, std::abs(_scales[i].x - _unpacked_scales[i].x) / _scales[i].x);
+		}
+
+		assert(max_position <= position_error);
+		assert(max_angle < 0.01f * (f32)(1u << (10 - config.rotation_bits)));
+		assert(max_scale < 1e-3f);
+
+		const u64 size{ transform::memory_size(_packed) };
+		std::cout << config.rotation_bits << " bit rotations, " << (config.scale == transform::scale_mode::uniform ? "uniform" : "half") << " scales, "
+			<< (config.cell_size > 0.f ? "cells of " : "full positions") << (config.cell_size > 0.f ? std::to_string((u32)config.cell_size) : std::string{}) << ": "
+			<< (f32)size / _num_transforms << " bytes per transform (" << 100.f * (f32)size / (f32)full_size << "%), packed in " << pack_ms << "ms, unpacked in "
+			<< unpack_ms << "ms\n    largest errors: position " << max_position << ", rotation " << max_angle << " radians, scale " << max_scale * 100.f << "%\n";
+	}
+
+	void check_cells() {
+		// The cells furthest from the origin on each side still get their own origins
+		const f32 edge{ 1048575.5f };
+		const math::v3 positions[2]{ { -edge, 0.5f, 0.5f }, { edge, 0.5f, 0.5f } };
+		const math::v4 rotations[2]{ { 0.f, 0.f, 0.f, 1.f }, { 0.f, 0.f, 0.f, 1.f } };
+		const math::v3 scales[2]{ { 1.f, 1.f, 1.f }, { 1.f, 1.f, 1.f } };
+		transform::packed_transforms packed;
+		[[maybe_unused]] bool exact{ transform::pack({ 10, transform::scale_mode::uniform, 1.f }, positions, rotations, scales, 2, packed) };
+		assert(exact && packed.cell_origins.size() == 2);
+
+		math::v3 unpacked[2];
+		math::v4 unpacked_rotations[2];
+		math::v3 unpacked_scales[2];
+		transform::unpack(packed, 0, 2, unpacked, unpacked_rotations, unpacked_scales);
+		for (u32 i{ 0 }; i < 2; i++) assert(std::abs(unpacked[i].x - positions[i].x) < 0.2f);
+
+		// One cell further doesn't fit into a cell key anymore
+		const math::v3 outside[2]{ { 0.5f, 0.5f, 0.5f }, { edge + 1.f, 0.5f, 0.5f } };
+		exact = transform::pack({ 10, transform::scale_mode::uniform, 1.f }, outside, rotations, scales, 2, packed);
+		assert(!exact);
+	}
+
+	void check_world() {
+		utl::vector<math::v3> before(_num_grievances);
+		for (u32 i{ 0 }; i < _num_grievances; i++) before[i] = _grievances[i].transform().position();
+
+		// Cells this small are too many to pack, and the world has to stay as it was
+		const u64 full_memory{ transform::memory_used() };
+		transform::packed_transforms packed;
+		[[maybe_unused]] bool exact{ transform::pack_data({ 10, transform::scale_mode::uniform, 0.01f }, packed) };
+		assert(!exact && !transform::is_packed() && !packed.count && transform::memory_used() == full_memory);
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			[[maybe_unused]] const math::v3 p{ _grievances[i].transform().position() };
+			assert(p.x == before[i].x && p.y == before[i].y && p.z == before[i].z);
+		}
+
+		// Pack the world, which frees its full precision arrays, and unpack it again
+		exact = transform::pack_data({ 10, transform::scale_mode::uniform, 16.f }, packed);
+		assert(exact && transform::is_packed());
+
+		const u64 packed_memory{ transform::memory_used() + transform::memory_size(packed) };
+		assert(packed_memory < full_memory);
+
+		transform::unpack_data(packed);
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			[[maybe_unused]] const math::v3 p{ _grievances[i].transform().position() };
+			assert(std::abs(p.x - before[i].x) < 1e-3f && std::abs(p.y - before[i].y) < 1e-3f && std::abs(p.z - before[i].z) < 1e-3f);
+		}
+
+		std::cout << "World of " << _num_grievances << " grievances: " << full_memory / 1024 << "KB of transforms, "
+			<< packed_memory / 1024 << "KB while packed, " << transform::memory_used() / 1024 << "KB after unpacking\n";
+	}
+};
\ No newline at end of file
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
+#include "../Engine/Components/Script.h"
+#include "../Engine/Components/Prefab.h"
+
+#include <iostream>
+#include <chrono>
+#include <ctime>
+
+using namespace revengine;
+
+// A small script, like the one a projectile would have
+class projectile_script : public script::grievance_script {
+public:
+	explicit projectile_script(revengine::grievance::grievance grievance) : revengine::script::grievance_script{ grievance } {}
+	void update(float dt) override { _lifetime -= dt; }
+
+private:
+	f32 _lifetime{ 5.f };
+};
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		// Get a random seed
+		srand((u32)time(nullptr));
+
+		_positions.resize(_burst_size);
+		_ids.resize(_burst_size);
+
+		check_stale_holes();
+		return true;
+	}
+
+	void run() override {
+		do {
+			using clock = std::chrono::high_resolution_clock;
+
+			// Spawn bursts of projectiles one grievance at a time
+			auto start{ clock::now() };
+			for (u32 burst{ 0 }; burst < _num_bursts; burst++) spawn_one_by_one();
+			const f32 single_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+			check_burst();
+			remove_all();
+
+			// Spawn the same bursts from a prefab
+			transform::init_info transform_info{};
+			script::init_info script_info{ &script::detail::create_script<projectile_script> };
+			const prefab::prefab projectile{ grievance::grievance_info{ &transform_info, &script_info } };
+
+			start = clock::now();
+			for (u32 burst{ 0 }; burst < _num_bursts; burst++) spawn_from_prefab(projectile);
+			const f32 prefab_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+			check_burst();
+			remove_all();
+
+			print_results(single_ms, prefab_ms);
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override {
+		remove_all();
+	}
+
+private:
+	static constexpr u32 _burst_size{ 500 };
+	static constexpr u32 _num_bursts{ 200 };
+
+	utl::vector<math::v3> _positions;
+	utl::vector<grievance::grievance_id> _ids;
+	utl::vector<grievance::grievance_id> _spawned;
+
+	void check_stale_holes() {
+		transform::init_info transform_info{};
+		grievance::grievance_info grievance_info{ &transform_info };
+		grievance::grievance_id ids[12];
+		for (u32 i{ 0 }; i < 10; i++) ids[i] = grievance::create(grievance_info).get_id();
+
+		// A partial defragment() trims the last slot off the end, but leaves its hole under the one of slot 3
+		grievance::remove(ids[9]);
+		grievance::remove(ids[3]);
+		grievance::remove(ids[5]);
+		transform::defragment(1, false);
+
+		// The batch has to skip the stale hole instead of writing past the end of the arrays
+		math::v3 positions[2]{ { 1.f, 2.f, 3.f }, { 4.f, 5.f, 6.f } };
+		transform::batch_info batch{};
+		batch.positions = positions;
+		grievance::create_batch(grievance_info, batch, 2, &ids[10]);
+
+		for (u32 i{ 0 }; i < 2; i++) {
+			const grievance::grievance grievance{ ids[10 + i] };
+			assert(grievance.transform().position().x == positions[i].x && grievance.transform().position().z == positions[i].z);
+		}
+
+		for (u32 i{ 0 }; i < 12; i++) {
+			if (i != 3 && i != 5 && i != 9) grievance::remove(ids[i]);
+		}
+
+		transform::defragment(u32_invalid_id, false);
+	}
+
+	void random_positions() {
+		for (math::v3& position : _positions) {
+			position = { (f32)(rand() % 1000), (f32)(rand() % 1000), (f32)(rand() % 1000) };
+		}
+	}
+
+	void spawn_one_by_one() {
+		random_positions();
+
+		transform::init_info transform_info{};
+		script::init_info script_info{ &script::detail::create_script<projectile_script> };
+		grievance::grievance_info grievance_info{ &transform_info, &script_info };
+
+		for (u32 i{ 0 }; i < _burst_size; i++) {
+			transform_info.position[0] = _positions[i].x;
+			transform_info.position[1] = _positions[i].y;
+			transform_info.position[2] = _positions[i].z;
+			_spawned.push_back(grievance::create(grievance_info).get_id());
+		}
+	}
+
+	void spawn_from_prefab(const prefab::prefab& projectile) {
+		random_positions();
+
+		transform::batch_info overrides{};
+		overrides.positions = _positions.data();
+		projectile.instantiate(_burst_size, _ids.data(), overrides);
+		_spawned.insert(_spawned.end(), _ids.begin(), _ids.end());
+	}
+
+	void check_burst() {
+		// The last burst has to be alive, with the right positions and a script each
+		const grievance::grievance_id* const burst{ &_spawned[_spawned.size() - _burst_size] };
+		for (u32 i{ 0 }; i < _burst_size; i++) {
+			const grievance::grievance grievance{ burst[i] };
+			assert(grievance::is_alive(grievance.get_id()));
+			assert(grievance.transform().position().x == _positions[i].x);
+			assert(grievance.transform().position().z == _positions[i].z);
+			assert(grievance.transform().scale().y == 1.f);
+			assert(grievance.script().is_valid());
+		}
+	}
+
+	void remove_all() {
+		for (grievance::grievance_id id : _spawned) grievance::remove(id);
+		_spawned.clear();
+	}
+
+	void print_results(f32 single_ms, f32 prefab_ms) {
+		// Print results
+		std::cout << "Spawned " << _num_bursts << " bursts of " << _burst_size << " grievances\n";
+		std::cout << "    One by one: " << single_ms << "ms, from a prefab: " << prefab_ms << "ms\n";
+	}
+};
\ No newline at end of file
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
+#include "../Engine/Components/Motion.h"
+#include "../Engine/Components/Renderable.h"
+#include "../Engine/Core/RenderExtraction.h"
+
+#include <iostream>
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace revengine;
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		// Get a random seed
+		srand((u32)time(nullptr));
+
+		// Half of the grievances move, most can be drawn, and a few of those are hidden
+		motion::init_info motion_info{};
+		motion_info.linear_velocity[0] = 1.f;
+		motion_info.angular_velocity[1] = 0.5f;
+
+		transform::init_info transform_info{};
+		transform_info.rotation[3] = 1.f;
+		renderable::init_info renderable_info{};
+
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			for (u32 j{ 0 }; j < 3; j++) transform_info.position[j] = (f32)(rand() % 1000);
+			transform_info.scale[0] = 1.f + (f32)(i % 3);
+			renderable_info.mesh = (u32)rand() % _num_meshes;
+			renderable_info.material = (u32)rand() % _num_materials;
+			renderable_info.visible = i % 10 != 0;
+
+			grievance::grievance_info grievance_info{ &transform_info, nullptr, nullptr, i & 1 ? &motion_info : nullptr, i % 16 ? &renderable_info : nullptr };
+			_grievances.push_back(grievance::create(grievance_info));
+			if (i % 16 && i % 10) ++_num_visible;
+		}
+
+		return true;
+	}
+
+	void run() override {
+		do {
+			check();
+
+			// Double the threads until every hardware thread extracts, and compare against the calling thread alone
+			const u32 max_threads{ std::max(4u, std::thread::hardware_concurrency()) };
+			f32 single_ms{ 0.f };
+			for (u32 threads{ 1 }; ; threads = std::min(2 * threads, max_threads)) {
+				const u32 worker_count{ threads - 1 };
+				extraction::initialize(worker_count);
+				const f32 ms{ benchmark() };
+				extraction::shutdown();
+				if (!worker_count) single_ms = ms;
+
+				std::cout << "Extracted " << _num_visible << " draws with " << worker_count << " workers: " << ms << "ms per frame, "
+					<< (f32)_num_visible / ms / 1000.f << "M draws per second, " << single_ms / ms << "x the calling thread alone\n";
+				if (threads == max_threads) break;
+			}
+
+			std::cout << std::thread::hardware_concurrency() << " hardware threads\n";
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override {
+		for (const grievance::grievance& g : _grievances) grievance::remove(g.get_id());
+		_grievances.clear();
+	}
+
+private:
+	static constexpr u32 _num_grievances{ 200000 };
+	static constexpr u32 _num_meshes{ 512 };
+	static constexpr u32 _num_materials{ 32 };
+	static constexpr u32 _num_frames{ 60 };
+
+	utl::vector<grievance::grievance> _grievances;
+	u32 _num_visible{ 0 };
+
+	// Draw lists waiting for the consumer
+	std::mutex _mutex;
+	std::condition_variable _signal;
+	utl::vector<extraction::draw_list> _pending;
+	bool _done{ false };
+
+	void check() {
+		extraction::initialize(2);
+		const extraction::draw_list list{ extraction::extract() };
+		assert(list.count == _num_visible);
+
+		for (u32 i{ 0 }; i < list.count; i++) {
+			const extraction::draw_item& item{ list.items[i] };
+			assert(!i || list.items[i - 1].key <= item.key);
+
+			// Draws with the same key stay in grievance order
+			assert(!i || list.items[i - 1].key != item.key || list.items[i - 1].grievance < item.grievance);
+
+			// The matrix has to hold the position, and the scale along the x axis
+			const transform::motivator t{ _grievances[item.grievance].transform() };
+			const math::v3 p{ t.position() };
+			const math::v3 s{ t.scale() };
+			assert(item.world[0][3] == p.x && item.world[1][3] == p.y && item.world[2][3] == p.z);
+
+			const f32 x_length{ std::sqrt(item.world[0][0] * item.world[0][0] + item.world[1][0] * item.world[1][0] + item.world[2][0] * item.world[2][0]) };
+			assert(std::abs(x_length - s.x) < 1e-4f);
+		}
+
+		extraction::release(list);
+		extraction::shutdown();
+	}
+
+	f32 benchmark() {
+		using clock = std::chrono::high_resolution_clock;
+
+		// The null consumer only walks the draws, like a renderer that records commands without a GPU
+		_done = false;
+		std::thread consumer{ [this]() {
+			f32 sum{ 0.f };
+			while (true) {
+				extraction::draw_list list;
+				{
+					std::unique_lock<std::mutex> lock{ _mutex };
+					_signal.wait(lock, [this] { return _done || !_pending.empty(); });
+					if (_pending.empty()) break;
+					list = _pending.front();
+					_pending.erase(_pending.begin());
+				}
+
+				for (u32 i{ 0 }; i < list.count; i++) sum += list.items[i].world[0][3];
+				extraction::release(list);
+			}
+
+			volatile f32 result{ sum };
+			(void)result;
+		} };
+
+		// Simulate the next frame while the consumer reads the last one
+		f32 extract_ms{ 0.f };
+		for (u32 frame{ 0 }; frame < _num_frames; frame++) {
+			motion::update(1.f / 60.f);
+
+			const auto start{ clock::now() };
+			const extraction::draw_list list{ extraction::extract() };
+			extract_ms += std::chrono::duration<f32, std::milli>(clock::now() - start).count();
+			assert(list.count == _num_visible);
+
+			{
+				std::lock_guard<std::mutex> lock{ _mutex };
+				_pending.push_back(list);
+			}
+
+			_signal.notify_one();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock{ _mutex };
+			_done = true;
+		}
+
+		_signal.notify_one();
+		consumer.join();
+		return extract_ms / _num_frames;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Core/Resource.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdio>
+
+using namespace revengine;
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		// Write files whose bytes are all the index of the file
+		for (u32 i{ 0 }; i < _num_files; i++) {
+			const utl::vector<char> data(_file_size, (char)i);
+			std::ofstream file{ path(i), std::ios::binary };
+			file.write(data.data(), data.size());
+			if (!file) return false;
+		}
+
+		resource::initialize(_num_workers, _budget);
+		return true;
+	}
+
+	void run() override {
+		do {
+			using clock = std::chrono::high_resolution_clock;
+			_loaded = 0;
+
+			// Start every load, then keep updating like a frame loop until they're all done
+			auto start{ clock::now() };
+			utl::vector<resource::handle<resource::blob>> handles;
+			for (u32 i{ 0 }; i < _num_files; i++) {
+				handles.push_back(resource::load<resource::blob>(path(i).c_str(), on_loaded, this));
+			}
+			const f32 request_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+
+			u32 frames{ 0 };
+			f32 update_ms{ 0.f };
+			while (_loaded < _num_files) {
+				const auto frame_start{ clock::now() };
+				resource::update();
+				update_ms = std::max(update_ms, std::chrono::duration<f32, std::milli>(clock::now() - frame_start).count());
+				++frames;
+			}
+			const f32 load_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+
+			// Loading a path again gives back the same resource
+			for (u32 i{ 0 }; i < _num_files; i++) {
+				assert(resource::load<resource::blob>(path(i).c_str()).get_id() == handles[i].get_id());
+				const resource::blob* const blob{ handles[i].get() };
+				assert(blob && blob->data.size() == _file_size && blob->data[_file_size / 2] == (u8)i);
+			}
+
+			// Everything stays loaded while it's referenced, even over the budget
+			assert(resource::memory_used() == (u64)_num_files * _file_size);
+
+			// Once the handles are gone, the least recently used resources are unloaded down to the budget
+			handles.clear();
+			resource::update();
+			assert(resource::memory_used() <= _budget);
+
+			// Missing files fail instead of blocking
+			resource::handle<resource::blob> missing{ resource::load<resource::blob>("missing_file.bin") };
+			while (resource::get_state(missing.get_id()) == resource::state::loading) resource::update();
+			assert(resource::get_state(missing.get_id()) == resource::state::failed && !missing.get());
+
+			print_results(request_ms, load_ms, update_ms, frames);
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override {
+		resource::shutdown();
+		for (u32 i{ 0 }; i < _num_files; i++) std::remove(path(i).c_str());
+	}
+
+private:
+	static constexpr u32 _num_files{ 64 };
+	static constexpr u32 _file_size{ 256 * 1024 };
+	static constexpr u32 _num_workers{ 4 };
+	static constexpr u64 _budget{ 4 * 1024 * 1024 };
+
+	u32 _loaded{ 0 };
+
+	static std::string path(u32 i) {
+		return "resource_test_" + std::to_string(i) + ".bin";
+	}
+
+	static void on_loaded(resource::resource_id, resource::state state, void* user_data) {
+		assert(state == resource::state::ready);
+		++static_cast<engine_test*>(user_data)->_loaded;
+	}
+
+	void print_results(f32 request_ms, f32 load_ms, f32 update_ms, u32 frames) {
+		const f32 megabytes{ (f32)_num_files * _file_size / (1024.f * 1024.f) };
+
+		// Print results
+		std::cout << "Requested " << _num_files << " files in " << request_ms << "ms, loaded " << megabytes << "MB in "
+			<< load_ms << "ms over " << frames << " updates\n";
+		std::cout << "    Longest update: " << update_ms << "ms, memory used after unloading: " << resource::memory_used() << " bytes\n";
+	}
+};
\ No newline at end of file
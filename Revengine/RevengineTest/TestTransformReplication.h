@@ -0,0 +1,157 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
+#include "../Engine/Core/TransformReplication.h"
+
+#include <iostream>
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <cstring>
+
+using namespace revengine;
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		// Get a random seed
+		srand((u32)time(nullptr));
+
+		// Create grievances with random transforms
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			transform::init_info transform_info{};
+			for (u32 j{ 0 }; j < 3; j++) {
+				transform_info.position[j] = random(-1000.f, 1000.f);
+				transform_info.scale[j] = random(0.5f, 2.f);
+			}
+			random_rotation(transform_info.rotation);
+
+			grievance::grievance_info grievance_info{
+				&transform_info,
+			};
+
+			_ids.push_back(grievance::create(grievance_info).get_id());
+		}
+
+		replication::capture(_ids.data(), (u32)_ids.size(), _server_state);
+		return true;
+	}
+
+	void run() override {
+		do {
+			// Start from nothing, as a client that just connected
+			_server_baseline = {};
+			_client_baseline = {};
+
+			for (u32 frame{ 0 }; frame < _num_frames; frame++) {
+				if (frame) move();
+				send_frame(frame);
+			}
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override { }
+
+private:
+	static constexpr u32 _num_grievances{ 10000 };
+	static constexpr u32 _num_frames{ 10 };
+
+	replication::config _config{};
+	utl::vector<grievance::grievance_id> _ids;
+	replication::transform_state _server_state;
+	replication::transform_state _client_state;
+	replication::quantized_state _server_quantized;
+	replication::quantized_state _server_baseline;
+	replication::quantized_state _client_baseline;
+	replication::quantized_state _client_quantized;
+	utl::vector<u8> _packet;
+
+	static f32 random(f32 min, f32 max) {
+		return min + (max - min) * (f32)rand() / (f32)RAND_MAX;
+	}
+
+	static void random_rotation(f32* q) {
+		f32 length{ 0.f };
+		while (length < 0.01f) {
+			length = 0.f;
+			for (u32 i{ 0 }; i < 4; i++) {
+				q[i] = random(-1.f, 1.f);
+				length += q[i] * q[i];
+			}
+		}
+
+		length = std::sqrt(length);
+		for (u32 i{ 0 }; i < 4; i++) q[i] /= length;
+	}
+
+	void move() {
+		// Move a tenth of the grievances a little, and turn some of those
+		const u32 count{ (u32)_server_state.ids.size() };
+		for (u32 i{ 0 }; i < count / 10; i++) {
+			const u32 index{ (u32)rand() % count };
+			math::v3& position{ _server_state.positions[index] };
+			position.x += random(-0.1f, 0.1f);
+			position.z += random(-0.1f, 0.1f);
+
+			if (rand() % 4 == 0) random_rotation(&_server_state.rotations[index].x);
+		}
+	}
+
+	void send_frame(u32 frame) {
+		using clock = std::chrono::high_resolution_clock;
+
+		// Server: quantize and encode against what the client has
+		auto start{ clock::now() };
+		replication::quantize(_config, _server_state, _server_quantized);
+		const u64 bits{ replication::encode(_config, _server_quantized, _server_baseline, _packet) };
+		const f32 encode_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+
+		// Client: decode the packet against its own baseline
+		start = clock::now();
+		const bool decoded{ replication::decode(_config, _packet.data(), (u32)_packet.size(), _client_baseline, _client_quantized) };
+		replication::dequantize(_config, _client_quantized, _client_state);
+		const f32 decode_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+
+		assert(decoded);
+		assert(_client_quantized.ids == _server_quantized.ids);
+		assert(!memcmp(_client_quantized.transforms.data(), _server_quantized.transforms.data(),
+			_server_quantized.transforms.size() * sizeof(replication::quantized_transform)));
+		check_error();
+
+		// A cut off packet has to be rejected, not read past its end
+		assert(!replication::decode(_config, _packet.data(), (u32)_packet.size() / 2, _client_baseline, _client_quantized) || _packet.size() < 2);
+		_client_quantized = _server_quantized;
+
+		// The client confirms the frame right away in a loopback, so both sides move their baseline along
+		_server_baseline = _server_quantized;
+		_client_baseline = _client_quantized;
+
+		print_results(frame, bits, encode_ms, decode_ms);
+	}
+
+	void check_error() {
+		const u32 count{ (u32)_server_state.ids.size() };
+		for (u32 i{ 0 }; i < count; i++) {
+			const f32* const a{ &_server_state.positions[i].x };
+			const f32* const b{ &_client_state.positions[i].x };
+			const f32* const qa{ &_server_state.rotations[i].x };
+			const f32* const qb{ &_client_state.rotations[i].x };
+
+			f32 dot{ 0.f };
+			for (u32 j{ 0 }; j < 3; j++) assert(std::abs(a[j] - b[j]) <= _config.position_precision);
+			for (u32 j{ 0 }; j < 4; j++) dot += qa[j] * qb[j];
+			assert(std::abs(dot) > 0.999f);
+		}
+	}
+
+	void print_results(u32 frame, u64 bits, f32 encode_ms, f32 decode_ms) {
+		const u32 count{ (u32)_server_state.ids.size() };
+		const f32 bytes_per_grievance{ (f32)bits / 8.f / count };
+
+		// Print results
+		std::cout << "Frame " << frame << ": " << _packet.size() << " bytes, " << bytes_per_grievance << " bytes per grievance\n";
+		std::cout << "    Encoded " << count / encode_ms / 1000.f << "M grievances/s, decoded " << count / decode_ms / 1000.f << "M grievances/s\n";
+	}
+};
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Test.h"
+#include "../Engine/Components/Grievance.h"
+#include "../Engine/Components/Transform.h"
+#include "../Engine/Core/WorldSnapshot.h"
+
+#include <iostream>
+#include <chrono>
+#include <ctime>
+
+using namespace revengine;
+
+class engine_test : public test {
+public:
+	bool initialize() override {
+		// Get a random seed
+		srand((u32)time(nullptr));
+
+		// Fill the world with grievances that can be recognized by their position
+		transform::init_info transform_info{};
+		grievance::grievance_info grievance_info{
+			&transform_info,
+		};
+
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			transform_info.position[0] = (f32)i;
+			_grievances.push_back(grievance::create(grievance_info));
+		}
+
+		return true;
+	}
+
+	void run() override {
+		do {
+			using clock = std::chrono::high_resolution_clock;
+
+			// Capture the world as it is now
+			auto start{ clock::now() };
+			snapshot::capture(_baseline);
+			const f32 capture_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+
+			// Change a small part of the world, then capture the change as a delta
+			churn();
+			start = clock::now();
+			snapshot::capture_delta(_baseline, _delta);
+			const f32 delta_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+			snapshot::capture(_changed);
+
+			// Roll back to the baseline and confirm that every original grievance is back where it was
+			start = clock::now();
+			snapshot::restore(_baseline);
+			const f32 restore_ms{ std::chrono::duration<f32, std::milli>(clock::now() - start).count() };
+			check_baseline();
+
+			// Restoring the delta has to give back exactly the changed world
+			snapshot::restore(_baseline, _delta);
+			snapshot::capture(_restored);
+			assert(_restored.blocks == _changed.blocks);
+
+			// Go back to the baseline for the next run
+			snapshot::restore(_baseline);
+
+			print_results(capture_ms, delta_ms, restore_ms);
+		} while (getchar() != 'q');
+	}
+
+	void shutdown() override { }
+
+private:
+	static constexpr u32 _num_grievances{ 100000 };
+
+	utl::vector<grievance::grievance> _grievances;
+	snapshot::world_snapshot _baseline;
+	snapshot::world_snapshot _changed;
+	snapshot::world_snapshot _restored;
+	snapshot::delta_snapshot _delta;
+
+	void churn() {
+		// Remove some random grievances and create a few new ones
+		for (u32 i{ 0 }; i < 100; i++) {
+			const grievance::grievance grievance{ _grievances[(u32)rand() % _num_grievances] };
+			if (grievance::is_alive(grievance.get_id())) grievance::remove(grievance.get_id());
+		}
+
+		transform::init_info transform_info{};
+		transform_info.position[0] = -1.f;
+		grievance::grievance_info grievance_info{
+			&transform_info,
+		};
+
+		for (u32 i{ 0 }; i < 50; i++) grievance::create(grievance_info);
+	}
+
+	void check_baseline() {
+		for (u32 i{ 0 }; i < _num_grievances; i++) {
+			assert(grievance::is_alive(_grievances[i].get_id()));
+			assert(_grievances[i].transform().position().x == (f32)i);
+		}
+	}
+
+	void print_results(f32 capture_ms, f32 delta_ms, f32 restore_ms) {
+		size_t full_size{ 0 };
+		for (const utl::vector<u8>& block : _baseline.blocks) full_size += block.size();
+
+		// Print results
+		std::cout << "Snapshot size: " << full_size << " bytes, captured in " << capture_ms << "ms\n";
+		std::cout << "Delta size: " << _delta.data.size() << " bytes in " << _delta.ranges.size() << " ranges, captured in " << delta_ms << "ms\n";
+		std::cout << "Restored in " << restore_ms << "ms\n";
+	}
+};
\ No newline at end of file